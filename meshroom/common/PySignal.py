@@ -77,6 +77,7 @@ class Signal(object):
         super(Signal, self).__init__()
         self._block = False
         self._sender = None
+        self._senderFrame = None
         self._slots = []
 
     def __call__(self, *args, **kwargs):
@@ -86,34 +87,19 @@ class Signal(object):
         """
         Calls all the connected slots with the provided args and kwargs unless block is activated
         """
-        if self._block:
+        if self._block or not self._slots:
+            # Nothing to notify: skip sender resolution and slots iteration
             return
 
-        def _get_sender():
-            """Try to get the bound, class or module method calling the emit."""
-            prev_frame = sys._getframe(2)
-            func_name = prev_frame.f_code.co_name
-
-            # Faster to try/catch than checking for 'self'
-            try:
-                return getattr(prev_frame.f_locals['self'], func_name)
-
-            except KeyError:
-                return getattr(inspect.getmodule(prev_frame), func_name)
-
-        # Get the sender
+        # Keep the emitting frame to resolve the sender on demand (see 'sender') during slots calls
+        previousFrame = self._senderFrame
+        self._senderFrame = sys._getframe(1)
         try:
-            self._sender = WeakMethod(_get_sender())
-
-        # Account for when func_name is at '<module>'
-        except AttributeError:
-            self._sender = None
-
-        # Handle unsupported module level methods for WeakMethod.
-        # TODO: Support module level methods.
-        except TypeError:
-            self._sender = None
+            self._callSlots(args, kwargs)
+        finally:
+            self._senderFrame = previousFrame
 
+    def _callSlots(self, args, kwargs):
         for slot in self._slots:
             if not slot:
                 continue
@@ -133,6 +119,18 @@ class Signal(object):
                 # Else call it in a standard way. Should be just lambdas at this point
                 slot(*args, **kwargs)
 
+    @staticmethod
+    def _resolveSender(frame):
+        """Try to get the bound, class or module method calling the emit from its frame."""
+        func_name = frame.f_code.co_name
+
+        # Faster to try/catch than checking for 'self'
+        try:
+            return getattr(frame.f_locals['self'], func_name)
+
+        except KeyError:
+            return getattr(inspect.getmodule(frame), func_name)
+
     def connect(self, slot):
         """
         Connects the signal to any callable object
@@ -195,7 +193,23 @@ class Signal(object):
         self._block = bool(isBlocked)
 
     def sender(self):
-        """Return the callable responsible for emitting the signal, if found."""
+        """
+        Return the callable responsible for emitting the signal, if found.
+        The sender is resolved on demand while the slots are being called, then the last resolved one is returned.
+        """
+        if self._senderFrame is not None:
+            try:
+                self._sender = WeakMethod(self._resolveSender(self._senderFrame))
+
+            # Account for when func_name is at '<module>'
+            except AttributeError:
+                self._sender = None
+
+            # Handle unsupported module level methods for WeakMethod.
+            # TODO: Support module level methods.
+            except TypeError:
+                self._sender = None
+
         try:
             return self._sender()
 
@@ -208,15 +222,21 @@ class ClassSignal(object):
     The class signal allows a signal to be set on a class rather than an instance.
     This emulates the behavior of a PyQt signal
     """
-    _map = {}
+    def __init__(self):
+        super(ClassSignal, self).__init__()
+        self._signals = weakref.WeakKeyDictionary()
 
     def __get__(self, instance, owner):
         if instance is None:
             # When we access ClassSignal element on the class object without any instance,
             # we return the ClassSignal itself
             return self
-        tmp = self._map.setdefault(self, weakref.WeakKeyDictionary())
-        return tmp.setdefault(instance, Signal())
+        # Only create the instance Signal on first access
+        try:
+            return self._signals[instance]
+        except KeyError:
+            signal = self._signals[instance] = Signal()
+            return signal
 
     def __set__(self, instance, value):
         raise RuntimeError("Cannot assign to a Signal object")
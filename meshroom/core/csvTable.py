@@ -0,0 +1,76 @@
+#!/usr/bin/env python
+# coding:utf-8
+"""
+Numeric CSV tables (e.g. camera response curves) read as compact columns.
+
+Rows are streamed and values are stored in typed arrays instead of lists of strings, and columns can be downsampled
+to the resolution of a chart while keeping their extrema.
+"""
+import csv
+import math
+from array import array
+
+
+def _toFloat(value):
+    try:
+        return float(value)
+    except ValueError:
+        return float('nan')
+
+
+def readColumns(filepath, shouldStop=None):
+    """
+    Read the CSV file 'filepath', whose first row contains the column titles.
+    Non-numeric values are read as NaN, missing values of short rows are ignored.
+
+    Args:
+        filepath (str): the CSV file
+        shouldStop (callable): function called for each row, returning True to stop reading (None is then returned)
+
+    Returns:
+        tuple: (titles, columns) with 'columns' a list of array('d'), None if stopped
+    """
+    with open(filepath, "r") as fp:
+        reader = csv.reader(fp)
+        titles = next(reader, [])
+        columns = [array('d') for _ in titles]
+        for row in reader:
+            if shouldStop and shouldStop():
+                return None
+            for column, value in zip(columns, row):
+                column.append(_toFloat(value))
+    return titles, columns
+
+
+def downsample(values, maxPoints):
+    """
+    Reduce 'values' to about 'maxPoints' (index, value) points to display them as a curve.
+    'values' are split in consecutive buckets, each represented by its minimum and maximum: peaks are preserved.
+    NaN values are skipped.
+
+    Args:
+        values (sequence of float): the values to downsample
+        maxPoints (int): the maximum number of points, all values are kept if 0 or not smaller than len(values)
+
+    Returns:
+        list of tuple: the (index, value) points, in index order
+    """
+    if not maxPoints or len(values) <= maxPoints:
+        return [(i, v) for i, v in enumerate(values) if not math.isnan(v)]
+    bucketSize = int(math.ceil(len(values) / float(max(maxPoints, 2) // 2)))
+    points = []
+    for start in range(0, len(values), bucketSize):
+        minIndex = maxIndex = None
+        for i in range(start, min(start + bucketSize, len(values))):
+            v = values[i]
+            if math.isnan(v):
+                continue
+            if minIndex is None or v < values[minIndex]:
+                minIndex = i
+            if maxIndex is None or v > values[maxIndex]:
+                maxIndex = i
+        if minIndex is None:
+            continue
+        for i in sorted({minIndex, maxIndex}):
+            points.append((i, values[i]))
+    return points
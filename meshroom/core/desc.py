@@ -1,10 +1,15 @@
 from meshroom.common import BaseObject, Property, Variant, VariantList, JSValue
 from meshroom.core import pyCompatibility
+from meshroom.core.progress import ProgressWriter, TextProgressBarParser
+from meshroom.core.sfmData import SfMDataCache
 from enum import Enum  # available by default in python3. For python2: "pip install enum34"
 import math
 import os
 import psutil
 import ast
+import errno
+import re
+import subprocess
 
 class Attribute(BaseObject):
     """
@@ -395,6 +400,29 @@ class MultiDynamicNodeSize(object):
         return size
 
 
+class SfMViewsNodeSize(DynamicNodeSize):
+    """
+    SfMViewsNodeSize defines the size of a Node as the number of views of an input SfMData attribute.
+    If the attribute is a link to another node, Node's size will be the same as this connected node.
+    Otherwise, the views of the SfMData JSON file are counted (Alembic, missing or invalid files can not be read: size is 1).
+    """
+    # parsed SfMData files, shared by all nodes
+    _sfmDataCache = SfMDataCache()
+
+    def computeSize(self, node):
+        param = node.attribute(self._param)
+        if param.isLink:
+            return super(SfMViewsNodeSize, self).computeSize(node)
+        if os.path.splitext(param.value)[1].lower() != '.sfm':
+            return 1
+        try:
+            views, _, _ = self._sfmDataCache.load(param.value)
+        except (ValueError, IOError, OSError):
+            # unreadable file (e.g. still being written): single chunk
+            return 1
+        return max(1, len(views))
+
+
 class StaticNodeSize(object):
     """
     StaticNodeSize expresses a static Node size in terms of individual tasks for parallelization.
@@ -452,6 +480,74 @@ class Node(object):
     def processChunk(self, chunk):
         raise NotImplementedError('No processChunk implementation on node: "{}"'.format(chunk.node.name))
 
+    def mergeChunks(self, node):
+        """ Combine the partial results of the chunks of a parallelized node into its outputs.
+
+        Called by 'chunkDone' once all chunks are done, by the process of the last chunk to finish
+        (chunks may be computed in parallel by separate processes). Must be idempotent.
+
+        Args:
+            node: the BaseNode instance whose chunks are all done
+        """
+        pass
+
+    @staticmethod
+    def chunksFolder(node):
+        """ Get the folder where the chunks of 'node' can store their partial results. """
+        return os.path.join(node.internalFolder, 'chunks')
+
+    @staticmethod
+    def chunkFolder(node, index):
+        """ Get the folder of the partial results of the chunk 'index' of 'node', in 'chunksFolder'. """
+        return os.path.join(Node.chunksFolder(node), str(index))
+
+    def _chunkDoneFile(self, chunk):
+        return os.path.join(self.chunksFolder(chunk.node), '{}.done'.format(chunk.index))
+
+    def _chunksMergeFile(self, node):
+        return os.path.join(self.chunksFolder(node), 'merge')
+
+    def chunkStarted(self, chunk):
+        """ Forget any previous completion of 'chunk' and merge of the chunks; to be called before computing it. """
+        for path in (self._chunkDoneFile(chunk), self._chunksMergeFile(chunk.node)):
+            try:
+                os.remove(path)
+            except OSError as e:
+                if e.errno != errno.ENOENT:
+                    raise
+
+    def chunkDone(self, chunk):
+        """ Mark 'chunk' as done and merge the chunks results (see 'mergeChunks') if all chunks are done.
+
+        Returns:
+            bool: whether the chunks results have been merged by this call
+        """
+        folder = self.chunksFolder(chunk.node)
+        try:
+            os.makedirs(folder)
+        except OSError:
+            if not os.path.isdir(folder):
+                raise
+        # the partial results of the chunk are complete once its marker exists
+        open(self._chunkDoneFile(chunk), 'w').close()
+        if not all(os.path.exists(self._chunkDoneFile(c)) for c in chunk.node.chunks):
+            return False
+        # chunks finishing at the same time may all see the others done: the one creating the merge marker merges
+        mergeFile = self._chunksMergeFile(chunk.node)
+        try:
+            os.close(os.open(mergeFile, os.O_CREAT | os.O_EXCL | os.O_WRONLY))
+        except OSError as e:
+            if e.errno != errno.EEXIST:
+                raise
+            return False
+        try:
+            self.mergeChunks(chunk.node)
+        except Exception:
+            # the merge can be claimed again
+            os.remove(mergeFile)
+            raise
+        return True
+
 
 class CommandLineNode(Node):
     """
@@ -460,7 +556,16 @@ class CommandLineNode(Node):
     parallelization = None
     commandLineRange = ''
 
-    def buildCommandLine(self, chunk):
+    def buildCommandLine(self, chunk, args=None):
+        """
+        Build the command line computing 'chunk'.
+
+        Args:
+            chunk: the NodeChunk to compute
+            args (dict): arguments of the chunk overriding the ones of the node (name -> value as written on the
+                         command line, None to remove the argument); the range arguments can be overridden too.
+                         Arguments that are not part of the command line are appended.
+        """
         cmdPrefix = ''
         # if rez available in env, we use it
         if 'REZ_ENV' in os.environ and chunk.node.packageVersion:
@@ -468,10 +573,21 @@ class CommandLineNode(Node):
             alreadyInEnv = os.environ.get('REZ_{}_VERSION'.format(chunk.node.packageName.upper()), "").startswith(chunk.node.packageVersion)
             if not alreadyInEnv:
                 cmdPrefix = '{rez} {packageFullName} -- '.format(rez=os.environ.get('REZ_ENV'), packageFullName=chunk.node.packageFullName)
+        args = dict(args or {})
         cmdSuffix = ''
         if chunk.node.isParallelized:
-            cmdSuffix = ' ' + self.commandLineRange.format(**chunk.range.toDict())
-        return cmdPrefix + chunk.node.nodeDesc.commandLine.format(**chunk.node._cmdVars) + cmdSuffix
+            rangeVars = chunk.range.toDict()
+            # range arguments, as '--name {rangeVar}' pairs of the template
+            for name, rangeVar in re.findall(r'--(\w+) \{(\w+)\}', self.commandLineRange):
+                value = args.pop(name) if name in args else rangeVars[rangeVar]
+                if value is not None:
+                    cmdSuffix += ' --{} {}'.format(name, value)
+        cmdVars = chunk.node.getCmdVars(args)
+        for name, value in args.items():
+            # arguments that are not attributes of the node
+            if name not in cmdVars and value is not None:
+                cmdSuffix += ' --{} {}'.format(name, value)
+        return cmdPrefix + chunk.node.nodeDesc.commandLine.format(**cmdVars) + cmdSuffix
 
     def stopProcess(self, chunk):
         # the same node could exists several times in the graph and
@@ -487,22 +603,36 @@ class CommandLineNode(Node):
             except psutil.NoSuchProcess:
                 pass
 
-    def processChunk(self, chunk):
+    def processChunk(self, chunk, args=None):
+        """ Compute 'chunk' with its command line, 'args' overriding arguments of the node (see buildCommandLine). """
         try:
-            with open(chunk.logFile, 'w') as logF:
-                cmd = self.buildCommandLine(chunk)
+            with open(chunk.logFile, 'wb') as logF:
+                cmd = self.buildCommandLine(chunk, args)
                 chunk.status.commandLine = cmd
                 chunk.saveStatusFile()
                 print(' - commandLine: {}'.format(cmd))
                 print(' - logFile: {}'.format(chunk.logFile))
-                chunk.subprocess = psutil.Popen(cmd, stdout=logF, stderr=logF, shell=True)
+                # chunks placed on a GPU device by the local computation only see this device
+                env = chunk.gpuDevice.environment() if chunk.gpuDevice else None
+                chunk.subprocess = psutil.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, shell=True, env=env)
 
                 # store process static info into the status file
                 # chunk.status.env = node.proc.environ()
                 # chunk.status.createTime = node.proc.create_time()
 
                 chunk.statThread.proc = chunk.subprocess
-                stdout, stderr = chunk.subprocess.communicate()
+                # forward process output to the log file while publishing
+                # its textual progress bars on the chunk's progress channel
+                progressParser = TextProgressBarParser(ProgressWriter(chunk.progressFile))
+                outputFd = chunk.subprocess.stdout.fileno()
+                while True:
+                    data = os.read(outputFd, 65536)
+                    if not data:
+                        break
+                    logF.write(data)
+                    logF.flush()
+                    progressParser.feed(data)
+                chunk.subprocess.stdout.close()
                 chunk.subprocess.wait()
 
                 chunk.status.returnCode = chunk.subprocess.returncode
@@ -0,0 +1,78 @@
+#!/usr/bin/env python
+# coding:utf-8
+"""
+Writing of files read concurrently by other threads or processes (caches, chunk results merged by the last chunk),
+and size limitation of cache folders.
+
+Files are written to a temporary file renamed once complete: readers never see a partial file.
+Temporary files have unique names: concurrent writers of the same file never write to the same temporary file,
+the last renamed one wins.
+"""
+import os
+import uuid
+
+
+def temporaryPath(path):
+    """ Get a unique temporary path to write 'path', in the same folder and with the same extension. """
+    root, ext = os.path.splitext(path)
+    return '{}.{}.tmp{}'.format(root, uuid.uuid4().hex, ext)
+
+
+def replaceFile(source, destination):
+    """ Rename 'source' to 'destination', replacing it if it exists. """
+    if hasattr(os, 'replace'):
+        os.replace(source, destination)
+        return
+    # python 2: no atomic replacement on Windows
+    if os.path.exists(destination):
+        os.remove(destination)
+    os.rename(source, destination)
+
+
+def writeFileAtomic(path, write):
+    """
+    Write the file 'path' with 'write', through a temporary file.
+
+    Args:
+        path (str): the file to write
+        write (callable): function(file) writing the content to a file object opened in text mode
+    """
+    tmpPath = temporaryPath(path)
+    try:
+        with open(tmpPath, 'w') as f:
+            write(f)
+        replaceFile(tmpPath, path)
+    finally:
+        if os.path.exists(tmpPath):
+            os.remove(tmpPath)
+
+
+def removeOldestFiles(folder, maxSize):
+    """
+    Remove the oldest files of 'folder' (recursively) until their total size is smaller than 'maxSize'.
+
+    Returns:
+        int: the number of removed files
+    """
+    files = []
+    totalSize = 0
+    for root, _, names in os.walk(folder):
+        for name in names:
+            path = os.path.join(root, name)
+            try:
+                stat = os.stat(path)
+            except OSError:
+                continue
+            files.append((stat.st_mtime, stat.st_size, path))
+            totalSize += stat.st_size
+    removed = 0
+    for _, size, path in sorted(files):
+        if totalSize <= maxSize:
+            break
+        try:
+            os.remove(path)
+        except OSError:
+            continue
+        totalSize -= size
+        removed += 1
+    return removed
@@ -0,0 +1,101 @@
+#!/usr/bin/env python
+# coding:utf-8
+"""
+GPU devices available to the local computation, on which the chunks of GPU nodes are placed.
+
+Devices are read from the MESHROOM_GPU_DEVICES environment variable (comma separated device ids, e.g. "0,1,2,3"),
+from CUDA_VISIBLE_DEVICES when Meshroom is already restricted to some devices (e.g. by a job scheduler),
+or detected with nvidia-smi. MESHROOM_FAKE_GPUS=<count> declares fake devices: chunks are scheduled as on a
+multi-GPU machine, without restricting the devices visible by their process (to test placement on CPU-only machines).
+
+The process of a chunk placed on a device only sees this device (CUDA_VISIBLE_DEVICES), and gets its id in
+MESHROOM_GPU_DEVICE. Device indices are those of nvidia-smi (CUDA_DEVICE_ORDER=PCI_BUS_ID), unless they are
+taken from CUDA_VISIBLE_DEVICES: they are then interpreted as in the Meshroom environment.
+"""
+import logging
+import os
+import subprocess
+from threading import Condition
+
+
+class GpuDevice(object):
+    """
+    A GPU device, identified by its id for CUDA_VISIBLE_DEVICES.
+    'deviceOrder' is the CUDA_DEVICE_ORDER the id refers to, None to keep the one of the environment.
+    """
+    def __init__(self, deviceId, fake=False, deviceOrder='PCI_BUS_ID'):
+        self.id = deviceId
+        self.fake = fake
+        self.deviceOrder = deviceOrder
+
+    def environment(self, baseEnvironment=None):
+        """ Get a copy of 'baseEnvironment' (the current one by default) restricted to this device. """
+        env = dict(os.environ if baseEnvironment is None else baseEnvironment)
+        env['MESHROOM_GPU_DEVICE'] = self.id
+        if not self.fake:
+            env['CUDA_VISIBLE_DEVICES'] = self.id
+            if self.deviceOrder:
+                env['CUDA_DEVICE_ORDER'] = self.deviceOrder
+        return env
+
+    def __repr__(self):
+        return 'GpuDevice({}{})'.format(self.id, ', fake' if self.fake else '')
+
+
+def _detectDeviceIds():
+    try:
+        output = subprocess.check_output(['nvidia-smi', '-L'], stderr=subprocess.STDOUT)
+    except (OSError, subprocess.CalledProcessError):
+        return []
+    # one "GPU <index>: <name> (UUID: ...)" line per device
+    lines = output.decode('utf-8', 'ignore').splitlines()
+    return [line.split(':')[0].split()[1] for line in lines if line.startswith('GPU ')]
+
+
+_devices = None
+
+
+def availableDevices():
+    """ Get the list of GpuDevice available to the local computation (detected once, until resetDevices). """
+    global _devices
+    if _devices is None:
+        fakeCount = os.environ.get('MESHROOM_FAKE_GPUS')
+        deviceIds = os.environ.get('MESHROOM_GPU_DEVICES')
+        visibleDeviceIds = os.environ.get('CUDA_VISIBLE_DEVICES')
+        if fakeCount:
+            _devices = [GpuDevice(str(i), fake=True) for i in range(int(fakeCount))]
+        elif deviceIds is not None:
+            _devices = [GpuDevice(d.strip()) for d in deviceIds.split(',') if d.strip()]
+        elif visibleDeviceIds is not None:
+            # only use the devices Meshroom is restricted to, with the same device order
+            _devices = [GpuDevice(d.strip(), deviceOrder=None) for d in visibleDeviceIds.split(',') if d.strip()]
+        else:
+            _devices = [GpuDevice(d) for d in _detectDeviceIds()]
+        logging.debug('GPU devices: {}'.format(_devices))
+    return _devices
+
+
+def resetDevices():
+    """ Forget the available devices, to read them again on next use (at the start of each local computation). """
+    global _devices
+    _devices = None
+
+
+class DevicePool(object):
+    """ Pool of devices, each one used by a single chunk at a time. Can be used from several threads. """
+    def __init__(self, devices):
+        self._free = list(devices)
+        self._condition = Condition()
+
+    def acquire(self):
+        """ Wait for a free device and get it. """
+        with self._condition:
+            while not self._free:
+                self._condition.wait()
+            return self._free.pop(0)
+
+    def release(self, device):
+        """ Give back 'device' to the pool. """
+        with self._condition:
+            self._free.append(device)
+            self._condition.notify()
@@ -7,6 +7,7 @@ import re
 import weakref
 from collections import defaultdict, OrderedDict
 from contextlib import contextmanager
+from multiprocessing.pool import ThreadPool
 
 from enum import Enum
 
@@ -16,7 +17,17 @@ from meshroom.common import BaseObject, DictModel, Slot, Signal, Property
 from meshroom.core import Version, pyCompatibility
 from meshroom.core.attribute import Attribute, ListAttribute
 from meshroom.core.exception import StopGraphVisit, StopBranchVisit
-from meshroom.core.node import nodeFactory, Status, Node, CompatibilityNode
+from meshroom.core.node import nodeFactory, loadStatusFile, Status, Node, CompatibilityNode
+
+try:
+    # optional native topology kernels (see src/graphCore)
+    from meshroom.core import _graphCore as graphCore
+except ImportError:
+    try:
+        # installed out of the source tree (see MR_GRAPHCORE_INSTALL_DIR) and found in PYTHONPATH
+        import _graphCore as graphCore
+    except ImportError:
+        graphCore = None
 
 # Replace default encoder to support Enums
 
@@ -137,10 +148,14 @@ def changeTopology(func):
     """
     def decorator(self, *args, **kwargs):
         assert isinstance(self, Graph)
+        # invalidate cached topological data, before and after the modification
+        # so that nested visits in 'func' do not rely on outdated data
+        self._topologyCache.clear()
         # call method
         result = func(self, *args, **kwargs)
         # mark graph dirty
         self.dirtyTopology = True
+        self._topologyCache.clear()
         # request graph update
         self.update()
         return result
@@ -163,6 +178,9 @@ class Graph(BaseObject):
 
     """
     _cacheDir = ""
+    # status files concurrent loading
+    statusLoadingMaxThreads = 16
+    statusLoadingMinFilesPerThread = 8
 
     class IO(object):
         """ Centralize Graph file keys and IO version. """
@@ -214,6 +232,8 @@ class Graph(BaseObject):
         self._updateEnabled = True
         self._updateRequested = False
         self.dirtyTopology = False
+        self._topologyCache = {}
+        self._dfsScratch = []
         self._nodesMinMaxDepths = {}
         self._computationBlocked = {}
         self._canComputeLeaves = True
@@ -226,6 +246,7 @@ class Graph(BaseObject):
 
     def clear(self):
         self.header.clear()
+        self._topologyCache.clear()
         self._compatibilityNodes.clear()
         self._edges.clear()
         # Tell QML nodes are going to be deleted
@@ -639,36 +660,58 @@ class Graph(BaseObject):
     def getInputEdges(self, node, dependenciesOnly):
         return set([edge for edge in self.getEdges(dependenciesOnly=dependenciesOnly) if edge.dst.node is node])
 
-    def _getInputEdgesPerNode(self, dependenciesOnly):
-        nodeEdges = defaultdict(set)
-
-        for edge in self.getEdges(dependenciesOnly=dependenciesOnly):
-            nodeEdges[edge.dst.node].add(edge.src.node)
-
-        return nodeEdges
-
-    def _getOutputEdgesPerNode(self, dependenciesOnly):
-        nodeEdges = defaultdict(set)
+    def _getIndexedTopology(self, dependenciesOnly):
+        """
+        Return the compact integer-indexed topology used by the native graph core, as a
+        (nodes, {node: index}, graphCore.GraphTopology) tuple.
+        Results are cached until the graph topology changes.
+        """
+        cacheKey = ("indexedTopology", dependenciesOnly)
+        indexedTopology = self._topologyCache.get(cacheKey)
+        if indexedTopology is None:
+            nodes = list(self._nodes)
+            nodeIndex = {node: i for i, node in enumerate(nodes)}
+            edges = [(nodeIndex[edge.dst.node], nodeIndex[edge.src.node]) for edge in self.getEdges(dependenciesOnly)]
+            indexedTopology = (nodes, nodeIndex, graphCore.GraphTopology(len(nodes), edges))
+            self._topologyCache[cacheKey] = indexedTopology
+        return indexedTopology
+
+    def _getNodeChildren(self, reverse, dependenciesOnly, longestPathFirst=False):
+        """
+        Return the children of each node for a visit in the given direction, as a {node: tuple(children)} dict.
+        Results are cached until the graph topology changes.
+        """
+        cacheKey = ("children", reverse, dependenciesOnly, longestPathFirst)
+        nodeChildren = self._topologyCache.get(cacheKey)
+        if nodeChildren is not None:
+            return nodeChildren
 
+        children = defaultdict(dict)  # use dict as an ordered set
         for edge in self.getEdges(dependenciesOnly=dependenciesOnly):
-            nodeEdges[edge.src.node].add(edge.dst.node)
+            if reverse:
+                children[edge.src.node][edge.dst.node] = None
+            else:
+                children[edge.dst.node][edge.src.node] = None
 
-        return nodeEdges
+        if longestPathFirst:
+            # Graph topology must be known and node depths up-to-date
+            assert not self.dirtyTopology
+            sortKey = lambda item: self._nodesMinMaxDepths[item][1]
+            nodeChildren = {u: tuple(sorted(c, reverse=True, key=sortKey)) for u, c in children.items()}
+        else:
+            nodeChildren = {u: tuple(c) for u, c in children.items()}
+        self._topologyCache[cacheKey] = nodeChildren
+        return nodeChildren
 
     def dfs(self, visitor, startNodes=None, longestPathFirst=False):
         # Default direction (visitor.reverse=False): from node to root
         # Reverse direction (visitor.reverse=True): from node to leaves
-        nodeChildren = self._getOutputEdgesPerNode(visitor.dependenciesOnly) if visitor.reverse else self._getInputEdgesPerNode(visitor.dependenciesOnly)
-        # Initialize color map
-        colors = {}
-        for u in self._nodes:
-            colors[u] = WHITE
-
         if longestPathFirst and visitor.reverse:
             # Because we have no knowledge of the node's count between a node and its leaves,
             # it is not possible to handle this case at the moment
             raise NotImplementedError("Graph.dfs(): longestPathFirst=True and visitor.reverse=True are not compatible yet.")
 
+        nodeChildren = self._getNodeChildren(visitor.reverse, visitor.dependenciesOnly, longestPathFirst)
         nodes = startNodes or (self.getRootNodes(visitor.dependenciesOnly) if visitor.reverse else self.getLeafNodes(visitor.dependenciesOnly))
 
         if longestPathFirst:
@@ -676,41 +719,81 @@ class Graph(BaseObject):
             assert not self.dirtyTopology
             nodes = sorted(nodes, key=lambda item: item.depth)
 
+        # Reuse color map and stack between visits (a new one is created for nested visits)
+        colors, stack = self._dfsScratch.pop() if self._dfsScratch else ({}, [])
         try:
             for node in nodes:
-                self.dfsVisit(node, visitor, colors, nodeChildren, longestPathFirst)
+                self.dfsVisit(node, visitor, colors, nodeChildren, stack)
         except StopGraphVisit:
             pass
+        finally:
+            colors.clear()
+            del stack[:]
+            self._dfsScratch.append((colors, stack))
 
-    def dfsVisit(self, u, visitor, colors, nodeChildren, longestPathFirst):
+    def dfsVisit(self, u, visitor, colors, nodeChildren, stack=None):
+        """
+        Visit the nodes reachable from 'u' in depth-first order, without recursion.
+        Nodes missing from 'colors' are considered as WHITE.
+
+        StopBranchVisit can be raised from any visitor callback: it stops the visit of the vertex being processed,
+        which then remains GRAY, and the visit continues with the finishEdge event of its parent.
+        """
+        stack = [] if stack is None else stack
+        noChildren = ()
         try:
-            self._dfsVisit(u, visitor, colors, nodeChildren, longestPathFirst)
+            colors[u] = GRAY
+            visitor.discoverVertex(u, self)
         except StopBranchVisit:
-            pass
+            return
+        # each stack frame is [vertex, children iterator, child whose visit has just ended]
+        stack.append([u, iter(nodeChildren.get(u, noChildren)), None])
 
-    def _dfsVisit(self, u, visitor, colors, nodeChildren, longestPathFirst):
-        colors[u] = GRAY
-        visitor.discoverVertex(u, self)
-        # d_time[u] = time = time + 1
-        children = nodeChildren[u]
-        if longestPathFirst:
-            assert not self.dirtyTopology
-            children = sorted(children, reverse=True, key=lambda item: self._nodesMinMaxDepths[item][1])
-        for v in children:
-            visitor.examineEdge((u, v), self)
-            if colors[v] == WHITE:
-                visitor.treeEdge((u, v), self)
-                # (u,v) is a tree edge
-                self.dfsVisit(v, visitor, colors, nodeChildren, longestPathFirst)  # TODO: avoid recursion
-            elif colors[v] == GRAY:
-                # (u,v) is a back edge
-                visitor.backEdge((u, v), self)
-            elif colors[v] == BLACK:
-                # (u,v) is a cross or forward edge
-                visitor.forwardOrCrossEdge((u, v), self)
-            visitor.finishEdge((u, v), self)
-        colors[u] = BLACK
-        visitor.finishVertex(u, self)
+        while stack:
+            frame = stack[-1]
+            u = frame[0]
+            try:
+                v = frame[2]
+                if v is not None:
+                    # (u,v) is a tree edge and the visit of v has ended
+                    frame[2] = None
+                    visitor.finishEdge((u, v), self)
+
+                v = next(frame[1], None)
+                if v is None:
+                    # all out-edges have been processed
+                    colors[u] = BLACK
+                    visitor.finishVertex(u, self)
+                    stack.pop()
+                    if stack:
+                        stack[-1][2] = u
+                    continue
+
+                visitor.examineEdge((u, v), self)
+                color = colors.get(v, WHITE)
+                if color == WHITE:
+                    # (u,v) is a tree edge
+                    visitor.treeEdge((u, v), self)
+                    frame[2] = v
+                    colors[v] = GRAY
+                    try:
+                        visitor.discoverVertex(v, self)
+                    except StopBranchVisit:
+                        continue
+                    stack.append([v, iter(nodeChildren.get(v, noChildren)), None])
+                    continue
+                elif color == GRAY:
+                    # (u,v) is a back edge
+                    visitor.backEdge((u, v), self)
+                else:
+                    # (u,v) is a cross or forward edge
+                    visitor.forwardOrCrossEdge((u, v), self)
+                visitor.finishEdge((u, v), self)
+            except StopBranchVisit:
+                # stop the visit of u and go back to its parent
+                stack.pop()
+                if stack:
+                    stack[-1][2] = u
 
     def dfsOnFinish(self, startNodes=None, longestPathFirst=False, reverse=False, dependenciesOnly=False):
         """
@@ -832,6 +915,26 @@ class Graph(BaseObject):
         self._nodesMinMaxDepths.clear()
         self._computationBlocked.clear()
 
+        leaves = self.getLeafNodes(dependenciesOnly=True)
+        if graphCore:
+            compatNodes = self._updateNodesTopologicalDataNative()
+        else:
+            compatNodes = self._updateNodesTopologicalDataPython(leaves)
+
+        # update graph computability status
+        canComputeLeaves = all([self.canCompute(node) for node in leaves])
+        if self._canComputeLeaves != canComputeLeaves:
+            self._canComputeLeaves = canComputeLeaves
+            self.canComputeLeavesChanged.emit()
+
+        # update compatibilityNodes model
+        if len(self._compatibilityNodes) != len(compatNodes):
+            self._compatibilityNodes.reset(compatNodes)
+
+    compatibilityNodes = Property(BaseObject, lambda self: self._compatibilityNodes, constant=True)
+
+    def _updateNodesTopologicalDataPython(self, leaves):
+        """ Compute nodes topological data using a DFS from the given leaves. Return the list of CompatibilityNodes. """
         compatNodes = []
         visitor = Visitor(reverse=False, dependenciesOnly=True)
 
@@ -867,22 +970,25 @@ class Graph(BaseObject):
             # propagate inputVertex computability
             self._computationBlocked[currentVertex] |= self._computationBlocked[inputVertex]
 
-        leaves = self.getLeafNodes(visitor.dependenciesOnly)
         visitor.finishEdge = finishEdge
         visitor.discoverVertex = discoverVertex
         self.dfs(visitor=visitor, startNodes=leaves)
-
-        # update graph computability status
-        canComputeLeaves = all([self.canCompute(node) for node in leaves])
-        if self._canComputeLeaves != canComputeLeaves:
-            self._canComputeLeaves = canComputeLeaves
-            self.canComputeLeavesChanged.emit()
-
-        # update compatibilityNodes model
-        if len(self._compatibilityNodes) != len(compatNodes):
-            self._compatibilityNodes.reset(compatNodes)
-
-    compatibilityNodes = Property(BaseObject, lambda self: self._compatibilityNodes, constant=True)
+        return compatNodes
+
+    def _updateNodesTopologicalDataNative(self):
+        """ Compute nodes topological data using the native graph core. Return the list of CompatibilityNodes. """
+        nodes, nodeIndex, topology = self._getIndexedTopology(dependenciesOnly=True)
+        minDepths, maxDepths = topology.minMaxDepths()
+        computed = [node.hasStatus(Status.SUCCESS) for node in nodes]
+        compatNodes = [node for node in nodes if isinstance(node, CompatibilityNode)]
+        # a not computed CompatibilityNode blocks computation
+        blocked = [isinstance(node, CompatibilityNode) and not isComputed for node, isComputed in zip(nodes, computed)]
+        blocked = topology.propagateBlocked(blocked, computed)
+
+        for i, node in enumerate(nodes):
+            self._nodesMinMaxDepths[node] = (minDepths[i], maxDepths[i])
+            self._computationBlocked[node] = blocked[i]
+        return compatNodes
 
     def dfsMaxEdgeLength(self, startNodes=None):
         """
@@ -915,16 +1021,54 @@ class Graph(BaseObject):
         Return as few edges as possible, such that if there is a directed path from one vertex to another in the
         original graph, there is also such a path in the reduction.
 
-        :param startNodes:
+        Nodes are processed in topological order and the set of nodes reachable from each of them is stored as a
+        bitset, which makes the reduction linear in the number of edges (times the bitset size).
+        Results are cached until the graph topology changes.
+
+        :param startNodes: list of starting nodes. Use all leaves if empty.
         :return: the remaining edges after a transitive reduction of the graph.
         """
-        flowEdges = []
-        edgesScore = self.dfsMaxEdgeLength(startNodes)
+        cacheKey = ("flowEdges", frozenset(startNodes) if startNodes else None)
+        flowEdges = self._topologyCache.get(cacheKey)
+        if flowEdges is None:
+            if graphCore:
+                nodes, nodeIndex, topology = self._getIndexedTopology(dependenciesOnly=False)
+                startIndices = [nodeIndex[node] for node in startNodes] if startNodes else \
+                               [nodeIndex[node] for node in self.getLeafNodes(dependenciesOnly=False)]
+                flowEdges = [(nodes[u], nodes[v]) for u, v in topology.transitiveReduction(startIndices)]
+            else:
+                flowEdges = self._transitiveReduction(startNodes)
+            self._topologyCache[cacheKey] = flowEdges
+        return list(flowEdges)
 
-        for link, score in edgesScore.items():
-            assert score != 0
-            if score == 1:
-                flowEdges.append(link)
+    def _transitiveReduction(self, startNodes=None):
+        """
+        Compute the transitive reduction of the graph visited from 'startNodes'.
+
+        :param startNodes: list of starting nodes. Use all leaves if empty.
+        :return: the list of (node, inputNode) edges kept by the reduction.
+        """
+        # finish order is a topological order: input nodes are listed before the nodes depending on them
+        nodes, edges = self.dfsOnFinish(startNodes=startNodes)
+        nodeIndex = {node: i for i, node in enumerate(nodes)}
+        nodeInputs = defaultdict(set)
+        for u, v in edges:
+            nodeInputs[u].add(v)
+
+        reachable = [0] * len(nodes)  # bitset of the nodes reachable from each node (itself excluded)
+        flowEdges = []
+        for i, u in enumerate(nodes):
+            # visit direct inputs from the closest to the farthest in topological order:
+            # any input reaching 'v' has a greater index than 'v' and is therefore accumulated before it
+            inputs = sorted((nodeIndex[v] for v in nodeInputs[u]), reverse=True)
+            accumulated = 0
+            for j in inputs:
+                bit = 1 << j
+                if not accumulated & bit:
+                    # 'v' can not be reached through another input: keep (u, v)
+                    flowEdges.append((u, nodes[j]))
+                accumulated |= reachable[j] | bit
+            reachable[i] = accumulated
         return flowEdges
 
     def getEdges(self, dependenciesOnly=False):
@@ -1064,9 +1208,60 @@ class Graph(BaseObject):
                 node.updateInternals()
 
     def updateStatusFromCache(self, force=False):
+        """
+        Update the status of dirty nodes (all nodes if 'force' is True) from their status files.
+
+        Each node's internal folder is listed once, unchanged status files (same path, mtime and size) are skipped
+        unless 'force' is True, and modified files are loaded concurrently.
+        Status changes are applied (and notified) from the calling thread.
+        """
+        folderStats = {}  # {folder: {filename: os.stat_result}}
+        chunksToLoad = []
         for node in self._nodes:
-            if node.dirty or force:
-                node.updateStatusFromCache()
+            if not (node.dirty or force):
+                continue
+            for chunk in node.chunks:
+                folder, filename = os.path.split(chunk.statusFile)
+                if folder not in folderStats:
+                    folderStats[folder] = self._listStatusFiles(folder)
+                fileStat = folderStats[folder].get(filename)
+                if fileStat is None:
+                    chunk.setStatusFromCache(None, None)
+                elif force or chunk.isStatusFileModified(fileStat):
+                    chunksToLoad.append((chunk, fileStat))
+
+        if not chunksToLoad:
+            return
+        statusFiles = [chunk.statusFile for chunk, _ in chunksToLoad]
+        if len(statusFiles) < Graph.statusLoadingMinFilesPerThread * 2:
+            statusData = [loadStatusFile(f) for f in statusFiles]
+        else:
+            nbThreads = min(Graph.statusLoadingMaxThreads, len(statusFiles) // Graph.statusLoadingMinFilesPerThread)
+            pool = ThreadPool(nbThreads)
+            try:
+                statusData = pool.map(loadStatusFile, statusFiles)
+            finally:
+                pool.close()
+                pool.join()
+
+        for (chunk, fileStat), data in zip(chunksToLoad, statusData):
+            chunk.setStatusFromCache(fileStat, data)
+
+    @staticmethod
+    def _listStatusFiles(folder):
+        """ Return the {filename: os.stat_result} of the status files in the given folder (empty if it does not exist). """
+        try:
+            filenames = os.listdir(folder)
+        except OSError:
+            return {}
+        fileStats = {}
+        for filename in filenames:
+            if filename == 'status' or filename.endswith('.status'):
+                try:
+                    fileStats[filename] = os.stat(os.path.join(folder, filename))
+                except OSError:
+                    pass
+        return fileStats
 
     def updateStatisticsFromCache(self):
         for node in self._nodes:
@@ -0,0 +1,115 @@
+#!/usr/bin/env python
+# coding:utf-8
+"""
+Persistent cache of the view and intrinsic computed for each image by CameraInit.
+
+Entries are identified by the path, modification time and size of their image, and by the CameraInit parameters
+used to compute them: modified images or parameters are detected as cache misses.
+Outdated entries are never read again: 'cleanup' removes the oldest entries when the cache folder gets too large.
+"""
+import hashlib
+import json
+import logging
+import os
+import time
+
+from meshroom.core.fileUtils import removeOldestFiles, writeFileAtomic
+
+
+def defaultCacheDir():
+    """ Get the cache folder (MESHROOM_CAMERAINIT_CACHE, defaults to the user cache location). """
+    cacheDir = os.environ.get("MESHROOM_CAMERAINIT_CACHE")
+    if cacheDir:
+        return cacheDir
+    userCache = os.environ.get("LOCALAPPDATA") or os.environ.get("XDG_CACHE_HOME") or os.path.expanduser("~/.cache")
+    return os.path.join(userCache, "meshroom", "cameraInit")
+
+
+def paramsKey(params):
+    """ Get the key identifying CameraInit parameters 'params' (dict of JSON serializable values). """
+    return hashlib.sha1(json.dumps(params, sort_keys=True).encode('utf-8')).hexdigest()
+
+
+class ImageIntrinsicsCache:
+    """ Cache of the (view, intrinsic) computed for each image, stored as one JSON file per entry. """
+    # minimum time (in seconds) between two cleanups by 'cleanupIfNeeded'
+    cleanupInterval = 24 * 3600
+
+    def __init__(self, cacheDir=None, maxCacheSize=256 * 1024 * 1024):
+        """
+        Args:
+            cacheDir (str): the folder where entries are stored (defaults to 'defaultCacheDir')
+            maxCacheSize (int): the size (in bytes) of the cache folder above which 'cleanup' removes entries
+        """
+        self.cacheDir = cacheDir or defaultCacheDir()
+        self.maxCacheSize = maxCacheSize
+
+    def entryPath(self, imagePath, paramsKey):
+        """ Get the path of the cache entry of 'imagePath' computed with 'paramsKey', None if the image does not exist. """
+        try:
+            stat = os.stat(imagePath)
+        except OSError:
+            return None
+        key = u'{}|{}|{}|{}'.format(os.path.abspath(imagePath), stat.st_mtime, stat.st_size, paramsKey).encode('utf-8')
+        digest = hashlib.sha1(key).hexdigest()
+        # split entries in sub-folders to keep folders small
+        return os.path.join(self.cacheDir, digest[:2], digest[2:] + '.json')
+
+    def get(self, imagePath, paramsKey):
+        """
+        Get the cached view and intrinsic of 'imagePath'.
+
+        Returns:
+            tuple: (view, intrinsic) dicts, intrinsic being None if the view has no intrinsic; None if not cached
+        """
+        path = self.entryPath(imagePath, paramsKey)
+        if not path or not os.path.isfile(path):
+            return None
+        try:
+            with open(path) as f:
+                entry = json.load(f)
+            return entry['view'], entry['intrinsic']
+        except (IOError, OSError, ValueError, KeyError) as e:
+            logging.debug("Invalid CameraInit cache entry '{}': {}".format(path, str(e)))
+            return None
+
+    def add(self, imagePath, paramsKey, view, intrinsic):
+        """ Store the view and intrinsic computed for 'imagePath'. """
+        path = self.entryPath(imagePath, paramsKey)
+        if not path:
+            return
+        folder = os.path.dirname(path)
+        if not os.path.isdir(folder):
+            try:
+                os.makedirs(folder)
+            except OSError:
+                # created by another process in the meantime
+                pass
+        try:
+            # other processes must never read a partial entry
+            writeFileAtomic(path, lambda f: json.dump({'view': view, 'intrinsic': intrinsic}, f))
+        except (IOError, OSError) as e:
+            logging.debug("Failed to write CameraInit cache entry '{}': {}".format(path, str(e)))
+
+    def cleanup(self):
+        """
+        Remove the oldest entries until the cache folder is smaller than 'maxCacheSize'.
+
+        Returns:
+            int: the number of removed entries
+        """
+        return removeOldestFiles(self.cacheDir, self.maxCacheSize)
+
+    def cleanupIfNeeded(self):
+        """ Run 'cleanup' if it has not been run for 'cleanupInterval' (by any process using the cache folder). """
+        marker = os.path.join(self.cacheDir, 'lastCleanup')
+        try:
+            if time.time() - os.path.getmtime(marker) < self.cleanupInterval:
+                return 0
+        except OSError:
+            # never cleaned up
+            pass
+        if not os.path.isdir(self.cacheDir):
+            return 0
+        open(marker, 'w').close()
+        return self.cleanup()
@@ -0,0 +1,107 @@
+#!/usr/bin/env python
+# coding:utf-8
+"""
+Layered layout of graphs.
+
+Nodes are assigned to layers (e.g. their depth in the graph), then the order of the nodes
+within each layer is refined to reduce the number of edge crossings using the barycenter heuristic:
+each node is placed at the average position of its neighbors in the previous layers (downward sweep)
+or in the next layers (upward sweep).
+"""
+from collections import defaultdict
+
+
+def orderLayers(layers, edges, sweeps=4):
+    """
+    Order the nodes of each layer to reduce edge crossings.
+
+    Args:
+        layers (list of list): the nodes of each layer, in their initial order
+        edges (iterable of tuple): the (src, dst) edges between nodes, with 'src' in a lower layer than 'dst'
+        sweeps (int): the number of downward/upward sweeps
+
+    Returns:
+        list of list: the reordered layers
+    """
+    layers = [list(layer) for layer in layers]
+    layerIndex = {}
+    for i, layer in enumerate(layers):
+        for node in layer:
+            layerIndex[node] = i
+
+    # neighbors in lower/upper layers, ignoring edges from/to nodes that are not laid out
+    lowerNeighbors = defaultdict(set)
+    upperNeighbors = defaultdict(set)
+    for src, dst in edges:
+        if src not in layerIndex or dst not in layerIndex or layerIndex[src] == layerIndex[dst]:
+            continue
+        if layerIndex[src] > layerIndex[dst]:
+            src, dst = dst, src
+        lowerNeighbors[dst].add(src)
+        upperNeighbors[src].add(dst)
+
+    # normalized position of each node in its layer, so that layers of different sizes can be compared
+    position = {}
+
+    def updatePositions(layer):
+        size = float(max(len(layer) - 1, 1))
+        for i, node in enumerate(layer):
+            position[node] = i / size
+
+    for layer in layers:
+        updatePositions(layer)
+
+    def sortLayer(layer, neighbors):
+        def barycenter(node):
+            nodeNeighbors = neighbors.get(node)
+            if not nodeNeighbors:
+                # keep nodes without neighbors around their current position
+                return position[node]
+            return sum(position[n] for n in nodeNeighbors) / len(nodeNeighbors)
+        # stable sort: ties keep their current relative order
+        layer.sort(key=barycenter)
+        updatePositions(layer)
+
+    for _ in range(sweeps):
+        for layer in layers[1:]:
+            sortLayer(layer, lowerNeighbors)
+        for layer in reversed(layers[:-1]):
+            sortLayer(layer, upperNeighbors)
+
+    return layers
+
+
+def countCrossings(layers, edges):
+    """
+    Count the crossings between edges connecting adjacent layers.
+
+    Args:
+        layers (list of list): the ordered nodes of each layer
+        edges (iterable of tuple): the (src, dst) edges between nodes
+
+    Returns:
+        int: the number of edge crossings
+    """
+    index = {}
+    for i, layer in enumerate(layers):
+        for j, node in enumerate(layer):
+            index[node] = (i, j)
+
+    edgesPerLayer = defaultdict(list)
+    for src, dst in edges:
+        if src not in index or dst not in index:
+            continue
+        (srcLayer, srcRank), (dstLayer, dstRank) = index[src], index[dst]
+        if abs(srcLayer - dstLayer) != 1:
+            continue
+        if srcLayer > dstLayer:
+            srcLayer, srcRank, dstRank = dstLayer, dstRank, srcRank
+        edgesPerLayer[srcLayer].append((srcRank, dstRank))
+
+    crossings = 0
+    for layerEdges in edgesPerLayer.values():
+        for i, (s1, d1) in enumerate(layerEdges):
+            for s2, d2 in layerEdges[i + 1:]:
+                if (s1 - s2) * (d1 - d2) < 0:
+                    crossings += 1
+    return crossings
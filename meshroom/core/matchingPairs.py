@@ -0,0 +1,91 @@
+#!/usr/bin/env python
+# coding:utf-8
+"""
+Image pairs lists (ImageMatching outputs) split in parts of balanced matching cost.
+
+A pairs list file has one line per image: its view id followed by the ids of the views it is paired with.
+The cost of matching a pair is estimated from the number of features of both images, using the size of their
+features files as a proxy: images with many features are much longer to match than the average one.
+"""
+import os
+
+
+def readPairs(pairsFile):
+    """ Get the (viewIdA, viewIdB) pairs of 'pairsFile', in file order. Blank lines are ignored. """
+    pairs = []
+    with open(pairsFile) as f:
+        for line in f:
+            ids = line.split()
+            if not ids:
+                continue
+            pairs.extend((ids[0], other) for other in ids[1:])
+    return pairs
+
+
+def writePairs(pairs, pairsFile):
+    """ Write 'pairs' to 'pairsFile', grouping consecutive pairs of the same first view on one line. """
+    with open(pairsFile, 'w') as f:
+        current = None
+        for a, b in pairs:
+            if a != current:
+                if current is not None:
+                    f.write('\n')
+                f.write(a)
+                current = a
+            f.write(' ' + b)
+        if current is not None:
+            f.write('\n')
+
+
+def featuresSize(viewId, featuresFolders, describerTypes):
+    """ Get the total size of the features files of 'viewId' (proxy for its number of features), 0 if not found. """
+    size = 0
+    for describerType in describerTypes:
+        name = '{}.{}.feat'.format(viewId, describerType)
+        for folder in featuresFolders:
+            path = os.path.join(folder, name)
+            if os.path.isfile(path):
+                size += os.path.getsize(path)
+                break
+    return size
+
+
+def pairCosts(pairs, featuresFolders, describerTypes):
+    """
+    Estimate the matching cost of each of 'pairs' from the features of both images.
+    Views without features files count as an average image.
+    """
+    sizes = {}
+    for pair in pairs:
+        for viewId in pair:
+            if viewId not in sizes:
+                sizes[viewId] = featuresSize(viewId, featuresFolders, describerTypes)
+    known = [s for s in sizes.values() if s]
+    average = float(sum(known)) / len(known) if known else 1.0
+    # constant part: geometric filtering and I/O of each pair
+    return [average + (sizes[a] or average) + (sizes[b] or average) for a, b in pairs]
+
+
+def partitionPairs(pairs, costs, nbParts):
+    """
+    Split 'pairs' in 'nbParts' contiguous parts of about the same total cost.
+    Parts are contiguous in the pairs order: the pairs of an image stay together, which limits the features
+    each part has to load.
+
+    Args:
+        pairs (list): the pairs to split
+        costs (list of float): the estimated cost of each pair (see pairCosts)
+        nbParts (int): the number of parts
+
+    Returns:
+        list of list: the pairs of each part (some parts may be empty if there are fewer pairs than parts)
+    """
+    total = float(sum(costs))
+    parts = [[] for _ in range(nbParts)]
+    accumulated = 0.0
+    for pair, cost in zip(pairs, costs):
+        # part containing the middle of the pair cost
+        index = int((accumulated + cost / 2.0) * nbParts / total) if total else 0
+        parts[min(index, nbParts - 1)].append(pair)
+        accumulated += cost
+    return parts
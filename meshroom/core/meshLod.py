@@ -0,0 +1,399 @@
+#!/usr/bin/env python
+# coding:utf-8
+"""
+Multi-resolution (level of detail) sidecars of OBJ meshes and point clouds.
+
+Levels are decimated versions of a source file, built by vertex clustering: vertices are merged per cell of a regular
+grid over the bounding box (averaging positions and colors), faces are remapped to the merged vertices and the
+degenerate or duplicated ones are dropped. Faces keep their original texture coordinates and materials.
+
+Levels are stored in a sidecar folder next to the source file ('<source>.lod'), described by a manifest that
+identifies the source by its modification time and size: modified sources are detected as outdated.
+The source file is streamed several times instead of being loaded, to build levels of very large files: the memory
+used by a level is bounded by its budget, the mapping of the source vertices to the merged ones is stored on disk.
+
+Only OBJ files are supported: Alembic point clouds are read by the qmlAlembic plugin and no Alembic reader
+is available to build their levels.
+"""
+import json
+import logging
+import mmap
+import os
+import shutil
+import struct
+import tempfile
+from array import array
+
+# default approximate number of vertices of each level, from coarsest to finest
+DEFAULT_BUDGETS = (50000, 500000)
+
+manifestName = 'lod.json'
+# version of the levels layout: sidecars written with another version are outdated
+lodVersion = 1
+
+
+class BuildCancelled(Exception):
+    """ Raised when the build of levels is stopped. """
+
+
+def _lines(f, shouldStop, checkInterval=65536):
+    """ Iterate over the lines of the file object 'f', raising BuildCancelled as soon as 'shouldStop' returns True. """
+    for i, line in enumerate(f):
+        if shouldStop and i % checkInterval == 0 and shouldStop():
+            raise BuildCancelled()
+        yield line
+
+
+def sidecarFolder(sourcePath):
+    """ Get the sidecar folder of 'sourcePath'. """
+    return sourcePath + '.lod'
+
+
+def sourceKey(sourcePath):
+    """ Get the key identifying the current version of 'sourcePath', None if the file does not exist. """
+    try:
+        stat = os.stat(sourcePath)
+    except OSError:
+        return None
+    return {'mtime': stat.st_mtime, 'size': stat.st_size}
+
+
+def readManifest(sourcePath):
+    """
+    Read the manifest of the sidecar of 'sourcePath'.
+
+    Returns:
+        dict: the manifest if the sidecar is up-to-date, None otherwise
+    """
+    key = sourceKey(sourcePath)
+    if key is None:
+        return None
+    try:
+        with open(os.path.join(sidecarFolder(sourcePath), manifestName)) as f:
+            manifest = json.load(f)
+    except (IOError, OSError, ValueError):
+        return None
+    if manifest.get('version') != lodVersion or manifest.get('source') != key:
+        return None
+    return manifest
+
+
+def levelPaths(sourcePath):
+    """ Get the paths of the levels of 'sourcePath' from coarsest to finest, empty if there is no up-to-date sidecar. """
+    manifest = readManifest(sourcePath)
+    if not manifest:
+        return []
+    folder = sidecarFolder(sourcePath)
+    return [os.path.join(folder, level['file']) for level in manifest['levels']]
+
+
+class ObjStats:
+    """ Bounding box and number of elements of an OBJ file. """
+    def __init__(self):
+        self.bboxMin = [float('inf')] * 3
+        self.bboxMax = [float('-inf')] * 3
+        self.vertexCount = 0
+        self.texCoordCount = 0
+        self.faceCount = 0
+        self.mtllibs = []
+
+
+def scanObj(path, shouldStop=None):
+    """ Compute the ObjStats of the OBJ file 'path'. """
+    stats = ObjStats()
+    bboxMin, bboxMax = stats.bboxMin, stats.bboxMax
+    with open(path, 'r') as f:
+        for line in _lines(f, shouldStop):
+            if line.startswith('v '):
+                values = line.split()
+                for i in range(3):
+                    c = float(values[i + 1])
+                    if c < bboxMin[i]:
+                        bboxMin[i] = c
+                    if c > bboxMax[i]:
+                        bboxMax[i] = c
+                stats.vertexCount += 1
+            elif line.startswith('vt '):
+                stats.texCoordCount += 1
+            elif line.startswith('f '):
+                stats.faceCount += 1
+            elif line.startswith('mtllib '):
+                stats.mtllibs.append(line[len('mtllib '):].strip())
+    return stats
+
+
+def gridResolution(stats, budget):
+    """
+    Get the initial number of cells along the largest dimension of the bounding box of 'stats' for a level of about
+    'budget' vertices. Meshes are sampled surfaces: the number of occupied cells is roughly proportional to the
+    square of the resolution. A level can not have more vertices than the source.
+    Levels of volumetric or noisy point clouds occupy more cells: they are checked and refined (see shrinkResolution).
+    """
+    return max(1, int(min(budget, stats.vertexCount) ** 0.5))
+
+
+def shrinkResolution(resolution, occupiedCells, budget):
+    """
+    Get a smaller resolution for a level of 'resolution' occupying 'occupiedCells' cells, over its 'budget'.
+    Occupied cells grow at least as the square of the resolution for surfaces and volumes:
+    the new resolution gives about 'budget' cells at most (curves may need another step).
+    """
+    return max(1, min(resolution - 1, int(resolution * (0.9 * budget / occupiedCells) ** 0.5)))
+
+
+class _Level:
+    """ Clustering state of a level being built. """
+    def __init__(self, index, resolution, budget, stats, folder):
+        self.index = index
+        self.resolution = resolution
+        self.budget = budget
+        self.file = 'level{}.obj'.format(index)
+        self.path = os.path.join(folder, self.file)
+        extent = max(stats.bboxMax[i] - stats.bboxMin[i] for i in range(3)) or 1.0
+        self.cellSize = extent / resolution
+        self.origin = stats.bboxMin
+        # cell key -> cluster index
+        self.clusters = {}
+        # per cluster: sum of x, y, z, r, g, b and number of vertices
+        self.sums = []
+        # file of the cluster index of each source vertex (only needed to remap faces)
+        self.mappingPath = self.path + '.map'
+        self._mappingFile = None
+        self._mappingBuffer = array('i')
+        # source texture coordinate index -> level texture coordinate index
+        self.texCoords = {}
+        # hashes of the faces of the level, to drop duplicated ones
+        self.faces = set()
+        self.faceCount = 0
+
+    def add(self, values, keepMapping):
+        size, origin = self.cellSize, self.origin
+        key = tuple(int((values[i] - origin[i]) / size) for i in range(3))
+        cluster = self.clusters.get(key)
+        if cluster is None:
+            cluster = self.clusters[key] = len(self.sums)
+            self.sums.append([0.0] * (len(values) + 1))
+        s = self.sums[cluster]
+        for i, v in enumerate(values):
+            s[i] += v
+        s[-1] += 1
+        if keepMapping:
+            self._mappingBuffer.append(cluster)
+            if len(self._mappingBuffer) >= 65536:
+                self.flushMapping()
+
+    def flushMapping(self):
+        """ Append the buffered cluster indices of the source vertices to the mapping file. """
+        if self._mappingFile is None:
+            self._mappingFile = open(self.mappingPath, 'wb')
+        self._mappingBuffer.tofile(self._mappingFile)
+        self._mappingBuffer = array('i')
+
+    def closeMapping(self):
+        if self._mappingBuffer:
+            self.flushMapping()
+        if self._mappingFile is not None:
+            self._mappingFile.close()
+            self._mappingFile = None
+
+
+def buildLevels(sourcePath, budgets=DEFAULT_BUDGETS, shouldStop=None):
+    """
+    Build the levels of the OBJ file 'sourcePath' in its sidecar folder, replacing outdated ones.
+    Budgets that are not smaller than the number of vertices of the source do not produce a level.
+
+    Args:
+        sourcePath (str): the OBJ file
+        budgets (list of int): the approximate number of vertices of each level
+        shouldStop (callable): function regularly called during the build, returning True to stop it
+                               (BuildCancelled is then raised)
+
+    Returns:
+        dict: the manifest of the sidecar
+    """
+    manifest = readManifest(sourcePath)
+    if manifest:
+        return manifest
+    key = sourceKey(sourcePath)
+    stats = scanObj(sourcePath, shouldStop)
+    folder = sidecarFolder(sourcePath)
+    # build levels in a temporary folder: readers must never see partial levels
+    buildFolder = tempfile.mkdtemp(prefix=os.path.basename(folder) + '.', dir=os.path.dirname(os.path.abspath(sourcePath)))
+    try:
+        levels = []
+        for budget in sorted(budgets):
+            if budget >= stats.vertexCount:
+                break
+            levels.append(_Level(len(levels), gridResolution(stats, budget), budget, stats, buildFolder))
+        if levels:
+            _clusterVertices(sourcePath, levels, stats.faceCount > 0, shouldStop)
+            # cluster again the levels over budget with larger cells
+            overBudget = [l for l in levels if len(l.sums) > l.budget]
+            while overBudget:
+                for level in overBudget:
+                    levels[level.index] = _Level(level.index, shrinkResolution(level.resolution, len(level.sums), level.budget),
+                                                 level.budget, stats, buildFolder)
+                overBudget = [levels[level.index] for level in overBudget]
+                _clusterVertices(sourcePath, overBudget, stats.faceCount > 0, shouldStop)
+                overBudget = [l for l in overBudget if len(l.sums) > l.budget]
+            if stats.faceCount:
+                _remapFaces(sourcePath, levels, shouldStop)
+            _writeLevels(sourcePath, stats, levels)
+        manifest = {
+            'version': lodVersion,
+            'source': key,
+            'vertexCount': stats.vertexCount,
+            'faceCount': stats.faceCount,
+            'levels': [{'file': l.file, 'vertexCount': len(l.sums), 'faceCount': l.faceCount} for l in levels],
+        }
+        with open(os.path.join(buildFolder, manifestName), 'w') as f:
+            json.dump(manifest, f, indent=4)
+        if os.path.exists(folder):
+            shutil.rmtree(folder)
+        os.rename(buildFolder, folder)
+    except Exception:
+        shutil.rmtree(buildFolder, ignore_errors=True)
+        raise
+    logging.debug("LOD levels of '{}': {}".format(sourcePath, manifest['levels']))
+    return manifest
+
+
+def _clusterVertices(sourcePath, levels, keepMapping, shouldStop):
+    try:
+        with open(sourcePath, 'r') as f:
+            for line in _lines(f, shouldStop):
+                if line.startswith('v '):
+                    values = [float(v) for v in line.split()[1:7]]
+                    for level in levels:
+                        level.add(values, keepMapping)
+    finally:
+        for level in levels:
+            level.closeMapping()
+
+
+class _Mapping:
+    """ Read access to the cluster index of each source vertex, memory-mapped from the mapping file of a level. """
+    _int = struct.Struct(array('i').typecode)
+
+    def __init__(self, level):
+        self._file = open(level.mappingPath, 'rb')
+        self._map = mmap.mmap(self._file.fileno(), 0, access=mmap.ACCESS_READ)
+
+    def __getitem__(self, index):
+        return self._int.unpack_from(self._map, index * self._int.size)[0]
+
+    def close(self):
+        self._map.close()
+        self._file.close()
+
+
+def _faceCorners(tokens, vertexCount):
+    """ Get the (vertex, texture coordinate) 0-based indices of the corners of a face. """
+    corners = []
+    for token in tokens:
+        indices = token.split('/')
+        v = int(indices[0])
+        vt = int(indices[1]) if len(indices) > 1 and indices[1] else None
+        corners.append((v - 1 if v > 0 else vertexCount + v, vt))
+    return corners
+
+
+def _remapFaces(sourcePath, levels, shouldStop):
+    # faces are written to temporary files, vertices and texture coordinates are known once all faces are read
+    source = open(sourcePath, 'r')
+    faceFiles = [open(level.path + '.faces', 'w') for level in levels]
+    mappings = [_Mapping(level) for level in levels]
+    try:
+        vertexCount = texCoordCount = 0
+        for line in _lines(source, shouldStop):
+            if line.startswith('v '):
+                vertexCount += 1
+            elif line.startswith('vt '):
+                texCoordCount += 1
+            elif line.startswith('usemtl ') or line.startswith('g '):
+                for faceFile in faceFiles:
+                    faceFile.write(line)
+            elif line.startswith('f '):
+                corners = _faceCorners(line.split()[1:], vertexCount)
+                for level, faceFile, mapping in zip(levels, faceFiles, mappings):
+                    # remap to clusters, dropping consecutive corners merged in the same cluster
+                    remapped = []
+                    for v, vt in corners:
+                        cluster = mapping[v]
+                        if not remapped or remapped[-1][0] != cluster:
+                            remapped.append((cluster, vt))
+                    if len(remapped) > 1 and remapped[0][0] == remapped[-1][0]:
+                        remapped.pop()
+                    if len(remapped) < 3:
+                        continue
+                    faceKey = hash(tuple(sorted(c for c, _ in remapped)))
+                    if faceKey in level.faces:
+                        continue
+                    level.faces.add(faceKey)
+                    tokens = []
+                    for cluster, vt in remapped:
+                        if vt is None:
+                            tokens.append(str(cluster + 1))
+                            continue
+                        if vt < 0:
+                            vt = texCoordCount + vt + 1
+                        newVt = level.texCoords.get(vt)
+                        if newVt is None:
+                            newVt = level.texCoords[vt] = len(level.texCoords) + 1
+                        tokens.append('{}/{}'.format(cluster + 1, newVt))
+                    faceFile.write('f {}\n'.format(' '.join(tokens)))
+                    level.faceCount += 1
+    finally:
+        source.close()
+        for faceFile in faceFiles:
+            faceFile.close()
+        for mapping in mappings:
+            mapping.close()
+    for level in levels:
+        level.faces = None
+        os.remove(level.mappingPath)
+
+
+def _readTexCoords(sourcePath, levels):
+    """ Get the texture coordinates used by each level, ordered by their index in the level. """
+    wanted = set()
+    for level in levels:
+        wanted.update(level.texCoords)
+    if not wanted:
+        return [[] for _ in levels]
+    values = {}
+    index = 0
+    with open(sourcePath, 'r') as f:
+        for line in f:
+            if line.startswith('vt '):
+                index += 1
+                if index in wanted:
+                    values[index] = line
+    result = []
+    for level in levels:
+        texCoords = [None] * len(level.texCoords)
+        for vt, newVt in level.texCoords.items():
+            texCoords[newVt - 1] = values[vt]
+        result.append(texCoords)
+    return result
+
+
+def _writeLevels(sourcePath, stats, levels):
+    sourceFolder = os.path.dirname(os.path.abspath(sourcePath))
+    levelsTexCoords = _readTexCoords(sourcePath, levels)
+    for level, texCoords in zip(levels, levelsTexCoords):
+        with open(level.path, 'w') as f:
+            f.write('# Level {} of {}\n'.format(level.index, os.path.basename(sourcePath)))
+            # material libraries are relative to the source file
+            for mtllib in stats.mtllibs:
+                mtlPath = mtllib if os.path.isabs(mtllib) else os.path.join(sourceFolder, mtllib)
+                f.write('mtllib {}\n'.format(os.path.relpath(mtlPath, os.path.dirname(level.path))))
+            for s in level.sums:
+                n = s[-1]
+                f.write('v {}\n'.format(' '.join('{:.6g}'.format(c / n) for c in s[:-1])))
+            f.writelines(texCoords)
+            facesPath = level.path + '.faces'
+            if os.path.exists(facesPath):
+                with open(facesPath, 'r') as faces:
+                    shutil.copyfileobj(faces, f)
+                os.remove(facesPath)
@@ -0,0 +1,393 @@
+#!/usr/bin/env python
+# coding:utf-8
+"""
+Partition of the meshing space into overlapping cells, meshed independently and merged afterwards.
+
+The space is a bounding box as defined by the Meshing node: the [-1, 1] cube scaled, rotated (Euler angles in degrees,
+applied as in the 3D viewer) and translated. It is split into a regular grid of cells in the box coordinates.
+Each cell is meshed within its core extended by an overlap, so that the surface is complete up to the core borders.
+When merging, each cell keeps the faces and points of its core only: the overlapping parts, meshed by both
+neighbour cells, are kept once. The vertices shared by neighbour cells along the core borders are welded: the surface
+is connected where their triangulations agree, and has small seams (cracks or overlapping triangles along the
+core borders) where they differ.
+
+Cell results are streamed one at a time: the memory needed to merge them is bounded by the size of one cell.
+"""
+import json
+import math
+from array import array
+
+from meshroom.core.fileUtils import writeFileAtomic
+
+
+def rotationMatrix(rotation):
+    """ Get the rotation matrix (rows) of the Euler angles 'rotation' (x, y, z in degrees): R = Ry * Rx * Rz. """
+    x, y, z = [math.radians(a) for a in rotation]
+    cx, sx, cy, sy, cz, sz = math.cos(x), math.sin(x), math.cos(y), math.sin(y), math.cos(z), math.sin(z)
+    rx = ((1, 0, 0), (0, cx, -sx), (0, sx, cx))
+    ry = ((cy, 0, sy), (0, 1, 0), (-sy, 0, cy))
+    rz = ((cz, -sz, 0), (sz, cz, 0), (0, 0, 1))
+
+    def mul(a, b):
+        return tuple(tuple(sum(a[i][k] * b[k][j] for k in range(3)) for j in range(3)) for i in range(3))
+    return mul(ry, mul(rx, rz))
+
+
+class Box(object):
+    """ Bounding box: the [-1, 1] cube scaled by 'scale', rotated by 'rotation' and translated by 'translation'. """
+
+    def __init__(self, translation=(0.0, 0.0, 0.0), rotation=(0.0, 0.0, 0.0), scale=(1.0, 1.0, 1.0)):
+        self.translation = tuple(float(v) for v in translation)
+        self.rotation = tuple(float(v) for v in rotation)
+        self.scale = tuple(float(v) for v in scale)
+        self._r = rotationMatrix(self.rotation)
+
+    def toLocal(self, p):
+        """ Get the coordinates of the world point 'p' in the box coordinates ([-1, 1] inside the box). """
+        d = [p[i] - self.translation[i] for i in range(3)]
+        # R^T * d, divided by the scale
+        return tuple(sum(self._r[k][i] * d[k] for k in range(3)) / self.scale[i] for i in range(3))
+
+    def toWorld(self, p):
+        """ Get the world coordinates of the point 'p' given in the box coordinates. """
+        s = [p[i] * self.scale[i] for i in range(3)]
+        return tuple(self.translation[i] + sum(self._r[i][k] * s[k] for k in range(3)) for i in range(3))
+
+    def subBox(self, lower, upper):
+        """ Get the box of the region between 'lower' and 'upper' corners given in the box coordinates. """
+        center = [(lower[i] + upper[i]) / 2.0 for i in range(3)]
+        halfSize = [(upper[i] - lower[i]) / 2.0 for i in range(3)]
+        return Box(self.toWorld(center), self.rotation, [halfSize[i] * self.scale[i] for i in range(3)])
+
+    def toList(self):
+        """ Get the [translation, rotation, scale] values of the box, as set to the Meshing 'boundingBox'. """
+        return [list(self.translation), list(self.rotation), list(self.scale)]
+
+
+def gridDimensions(nbCells, box):
+    """
+    Get the number of cells along each axis of 'box' to split it in 'nbCells' cells as close to cubes as possible.
+
+    Returns:
+        tuple: (nx, ny, nz) with nx * ny * nz == nbCells
+    """
+    extents = [abs(s) for s in box.scale]
+    best, bestSize = None, None
+    for nx in range(1, nbCells + 1):
+        if nbCells % nx:
+            continue
+        for ny in range(1, nbCells // nx + 1):
+            if (nbCells // nx) % ny:
+                continue
+            dims = (nx, ny, nbCells // nx // ny)
+            # size of the longest cell edge
+            size = max(extents[i] / dims[i] for i in range(3))
+            if bestSize is None or size < bestSize:
+                best, bestSize = dims, size
+    return best
+
+
+class Partition(object):
+    """
+    Regular grid of 'nbCells' cells over 'box', meshed with an 'overlap' (fraction of the cell size) around each cell.
+    Cells are indexed from 0 to nbCells - 1.
+    """
+
+    def __init__(self, box, nbCells, overlap=0.1):
+        self.box = box
+        self.nbCells = nbCells
+        self.overlap = overlap
+        self.dims = gridDimensions(nbCells, box)
+
+    def _cellCoords(self, index):
+        nx, ny, nz = self.dims
+        return index // (ny * nz), (index // nz) % ny, index % nz
+
+    def cellBox(self, index):
+        """ Get the box meshed for cell 'index': its core extended by the overlap, within the partition box. """
+        lower, upper = [], []
+        for axis, c in enumerate(self._cellCoords(index)):
+            size = 2.0 / self.dims[axis]
+            lower.append(max(-1.0, -1.0 + (c - self.overlap) * size))
+            upper.append(min(1.0, -1.0 + (c + 1 + self.overlap) * size))
+        return self.box.subBox(lower, upper)
+
+    def cellOf(self, p):
+        """ Get the index of the cell whose core contains the world point 'p' (points outside the box belong to the border cells). """
+        local = self.box.toLocal(p)
+        coords = [min(self.dims[axis] - 1, max(0, int(math.floor((local[axis] + 1.0) * self.dims[axis] / 2.0))))
+                  for axis in range(3)]
+        return (coords[0] * self.dims[1] + coords[1]) * self.dims[2] + coords[2]
+
+    def isNearBorder(self, p):
+        """ Whether the world point 'p' is within the overlap distance of a border between two cell cores. """
+        local = self.box.toLocal(p)
+        for axis in range(3):
+            if self.dims[axis] < 2:
+                continue
+            # position in cells along the axis: borders are at integer positions from 1 to dims - 1
+            t = (local[axis] + 1.0) * self.dims[axis] / 2.0
+            border = min(max(int(round(t)), 1), self.dims[axis] - 1)
+            if abs(t - border) <= self.overlap:
+                return True
+        return False
+
+
+class _JsonStream(object):
+    """ Incremental reader of a JSON text file, decoding its values one at a time from blocks of the file. """
+
+    def __init__(self, f, blockSize=1 << 20):
+        self._f = f
+        self._blockSize = blockSize
+        self._buffer = ''
+        self._pos = 0
+        self._eof = False
+        self._decoder = json.JSONDecoder()
+
+    def _read(self, size):
+        """ Append a block of 'size' characters to the buffer, dropping the decoded part. Returns False at the end. """
+        block = self._f.read(size)
+        self._eof = not block
+        self._buffer = self._buffer[self._pos:] + block
+        self._pos = 0
+        return not self._eof
+
+    def peek(self):
+        """ Get the next non-whitespace character, an empty string at the end of the file. """
+        while True:
+            while self._pos < len(self._buffer) and self._buffer[self._pos].isspace():
+                self._pos += 1
+            if self._pos < len(self._buffer):
+                return self._buffer[self._pos]
+            if not self._read(self._blockSize):
+                return ''
+
+    def skip(self, chars):
+        """ Consume the next non-whitespace character if it is one of 'chars'. Returns whether it has been consumed. """
+        if self.peek() and self.peek() in chars:
+            self._pos += 1
+            return True
+        return False
+
+    def value(self):
+        """ Decode the next value. """
+        self.peek()
+        size = self._blockSize
+        while True:
+            try:
+                value, end = self._decoder.raw_decode(self._buffer, self._pos)
+                # a value at the end of the buffer may be truncated (e.g. a number)
+                if end < len(self._buffer) or self._eof:
+                    self._pos = end
+                    return value
+            except ValueError:
+                if self._eof:
+                    raise
+            self._read(size)
+            size *= 2
+
+
+def iterSfMData(sfmFile):
+    """
+    Iterate over the top level values of the SfMData JSON file 'sfmFile', read one at a time: the elements of the lists
+    (views, poses, structure...) are decoded and yielded one by one, so that the file is never loaded at once.
+
+    Yields:
+        tuple: (key, element) for each element of a list, (key, value) for the other values
+    """
+    with open(sfmFile) as f:
+        stream = _JsonStream(f)
+        if not stream.skip('{'):
+            raise ValueError('"{}" is not an SfMData JSON file.'.format(sfmFile))
+        while stream.peek() not in ('}', ''):
+            key = stream.value()
+            stream.skip(':')
+            if stream.skip('['):
+                while stream.peek() not in (']', ''):
+                    yield key, stream.value()
+                    stream.skip(',')
+                stream.skip(']')
+            else:
+                yield key, stream.value()
+            stream.skip(',')
+
+
+def _maxObservationAngle(point, centers):
+    """ Get the largest angle (in degrees) between the rays from the camera 'centers' to 'point'. """
+    rays = []
+    for center in centers:
+        ray = [point[axis] - center[axis] for axis in range(3)]
+        norm = math.sqrt(sum(v * v for v in ray))
+        if norm > 0.0:
+            rays.append([v / norm for v in ray])
+    maxAngle = 0.0
+    for i in range(len(rays)):
+        for j in range(i + 1, len(rays)):
+            cosAngle = max(-1.0, min(1.0, sum(rays[i][axis] * rays[j][axis] for axis in range(3))))
+            maxAngle = max(maxAngle, math.degrees(math.acos(cosAngle)))
+    return maxAngle
+
+
+def estimateBoundingBox(sfmFile, minObservations=0, minObservationAngle=0.0, quantile=0.01, margin=0.05):
+    """
+    Estimate the bounding box of the scene from the landmarks of the SfMData JSON file 'sfmFile', streamed from the
+    file (see iterSfMData). Outliers are ignored: the box contains the landmarks between the 'quantile' and
+    1 - 'quantile' of each axis, extended by 'margin' (fraction of its size).
+
+    Args:
+        sfmFile (str): the SfMData JSON file
+        minObservations (int): the minimum number of observations of the landmarks to consider
+        minObservationAngle (float): the minimum angle (in degrees) between two observations of the landmarks to
+                                     consider, observations from views without pose being ignored
+
+    Returns:
+        Box: the axis-aligned bounding box, None if there are no landmarks
+    """
+    # camera centers of the views, read before the landmarks whatever the order of the file
+    viewPoses, poseCenters = {}, {}
+    if minObservationAngle > 0.0:
+        for key, value in iterSfMData(sfmFile):
+            if key == 'views' and 'poseId' in value:
+                viewPoses[value['viewId']] = value['poseId']
+            elif key == 'poses':
+                poseCenters[value['poseId']] = [float(v) for v in value['pose']['transform']['center']]
+    centers = {viewId: poseCenters[poseId] for viewId, poseId in viewPoses.items() if poseId in poseCenters}
+    del viewPoses, poseCenters
+
+    coords = [array('d') for _ in range(3)]
+    for key, landmark in iterSfMData(sfmFile):
+        if key != 'structure':
+            continue
+        observations = landmark.get('observations', [])
+        if len(observations) < minObservations:
+            continue
+        point = [float(v) for v in landmark['X']]
+        if minObservationAngle > 0.0:
+            observationCenters = [centers[o['observationId']] for o in observations if o.get('observationId') in centers]
+            if _maxObservationAngle(point, observationCenters) < minObservationAngle:
+                continue
+        for axis in range(3):
+            coords[axis].append(point[axis])
+    if not coords[0]:
+        return None
+    translation, scale = [], []
+    for values in coords:
+        values = sorted(values)
+        low = values[int(quantile * (len(values) - 1))]
+        high = values[int(math.ceil((1.0 - quantile) * (len(values) - 1)))]
+        translation.append((low + high) / 2.0)
+        scale.append(max((high - low) / 2.0 * (1.0 + margin), 1e-6))
+    return Box(translation, (0.0, 0.0, 0.0), scale)
+
+
+def _readObjCell(path, partition, cell):
+    """
+    Read the vertices and faces of the OBJ mesh of 'cell' that belong to its core.
+    Faces are assigned to the cell containing their centroid; texture coordinates and normals are dropped.
+
+    Returns:
+        tuple: (vertex lines of the used vertices, their positions, faces as lists of 0-based indices in these vertices)
+    """
+    positions = array('d')
+    with open(path) as f:
+        for line in f:
+            if line.startswith('v '):
+                positions.extend(float(v) for v in line.split()[1:4])
+    vertexCount = len(positions) // 3
+    faces = []
+    used = bytearray(vertexCount)
+    with open(path) as f:
+        for line in f:
+            if not line.startswith('f '):
+                continue
+            face = []
+            for token in line.split()[1:]:
+                v = int(token.split('/')[0])
+                face.append(v - 1 if v > 0 else vertexCount + v)
+            centroid = [sum(positions[3 * v + axis] for v in face) / len(face) for axis in range(3)]
+            if partition.cellOf(centroid) != cell:
+                continue
+            faces.append(face)
+            for v in face:
+                used[v] = 1
+    # keep the original vertex lines (with their colors)
+    remap = array('l', [0]) * vertexCount
+    vertexLines, vertexPositions = [], []
+    with open(path) as f:
+        index = 0
+        for line in f:
+            if not line.startswith('v '):
+                continue
+            if used[index]:
+                remap[index] = len(vertexLines)
+                vertexLines.append(line)
+                vertexPositions.append(positions[3 * index:3 * index + 3])
+            index += 1
+    return vertexLines, vertexPositions, [[remap[v] for v in face] for face in faces]
+
+
+def mergeMeshes(cellMeshes, partition, outputPath, tolerance=1e-6):
+    """
+    Merge the OBJ meshes of the cells of 'partition' into 'outputPath'.
+    Vertices near the core borders that are at the same position (within 'tolerance', a fraction of the partition
+    box size) in neighbour cells are welded. Faces made degenerate by the welding are dropped.
+
+    Args:
+        cellMeshes (list of str): the OBJ mesh of each cell, by cell index
+    """
+    step = tolerance * max(abs(s) for s in partition.box.scale)
+    # quantized position -> 1-based index in the output, for the vertices near the core borders
+    borderVertices = {}
+
+    def write(out):
+        vertexCount = 0
+        for cell, path in enumerate(cellMeshes):
+            vertexLines, vertexPositions, faces = _readObjCell(path, partition, cell)
+            remap = []
+            for line, position in zip(vertexLines, vertexPositions):
+                key = tuple(int(round(c / step)) for c in position) if partition.isNearBorder(position) else None
+                index = borderVertices.get(key) if key else None
+                if index is None:
+                    out.write(line)
+                    vertexCount += 1
+                    index = vertexCount
+                    if key:
+                        borderVertices[key] = index
+                remap.append(index)
+            for face in faces:
+                face = [remap[v] for v in face]
+                if len(set(face)) < 3:
+                    continue
+                out.write('f {}\n'.format(' '.join(str(v) for v in face)))
+    writeFileAtomic(outputPath, write)
+
+
+def mergeStructures(cellSfMFiles, partition, outputPath):
+    """
+    Merge the landmarks of the SfMData JSON files of the cells of 'partition' into 'outputPath'.
+    Landmarks are renumbered; views, intrinsics, poses and other values are taken from the first cell.
+
+    Args:
+        cellSfMFiles (list of str): the SfMData JSON file of each cell, by cell index
+    """
+    def write(out):
+        landmarkId = 0
+        for cell, path in enumerate(cellSfMFiles):
+            with open(path) as f:
+                sfmData = json.load(f)
+            structure = sfmData.pop('structure', [])
+            if cell == 0:
+                out.write('{\n')
+                for key, value in sfmData.items():
+                    out.write('{}: {},\n'.format(json.dumps(key), json.dumps(value, indent=4)))
+                out.write('"structure": [')
+            for landmark in structure:
+                if partition.cellOf([float(v) for v in landmark['X']]) != cell:
+                    continue
+                landmark['landmarkId'] = str(landmarkId)
+                out.write('{}\n{}'.format(',' if landmarkId else '', json.dumps(landmark)))
+                landmarkId += 1
+            # release the cell before reading the next one
+            del structure, sfmData
+        out.write(']\n}\n')
+    writeFileAtomic(outputPath, write)
@@ -20,12 +20,36 @@ from meshroom.common import Signal, Variant, Property, BaseObject, Slot, ListMod
 from meshroom.core import desc, stats, hashValue, pyCompatibility, nodeVersion, Version
 from meshroom.core.attribute import attributeFactory, ListAttribute, GroupAttribute, Attribute
 from meshroom.core.exception import NodeUpgradeError, UnknownNodeTypeError
+from meshroom.core.progress import ProgressReader, ProgressWriter
 
 
 def getWritingFilepath(filepath):
     return filepath + '.writing.' + str(uuid.uuid4())
 
 
+def statusFileCacheKey(filepath, fileStat):
+    """
+    Key identifying the content of a status file, based on its path, inode, modification time and size.
+    The inode changes when the file is replaced by a new one (see getWritingFilepath), even with the same size
+    within the modification time resolution.
+    """
+    return filepath, fileStat.st_ino, getattr(fileStat, 'st_mtime_ns', fileStat.st_mtime), fileStat.st_size
+
+
+def loadStatusFile(filepath):
+    """
+    Load the content of a status file.
+
+    Returns:
+        dict: the status data, None if the file does not exist (anymore)
+    """
+    try:
+        with open(filepath, 'r') as jsonFile:
+            return json.load(jsonFile)
+    except (IOError, OSError):
+        return None
+
+
 def renameWritingToFinalPath(writingFilepath, filepath):
     if platform.system() == 'Windows':
         # On Windows, attempting to remove a file that is in use causes an exception to be raised.
@@ -165,6 +189,7 @@ class LogManager:
         self.configureLogger()
         self.logger.setLevel(self.textToLevel(level))
         self.progressBar = False
+        self.progressWriter = ProgressWriter(self.chunk.progressFile)
 
     def end(self):
         for handler in self.logger.handlers[:]:
@@ -178,34 +203,31 @@ class LogManager:
         self.progressEnd = end
         self.currentProgressTics = 0
         self.progressBar = True
-        
-        with open(self.chunk.logFile, 'a') as f:
+        self.progressWriter.begin(end, message)
+
+        # binary mode: tell() gives the byte offset of the progress bar line, where updateProgressBar seeks
+        with open(self.chunk.logFile, 'ab') as f:
             if message:
-                f.write(message+'\n')
-            f.write('0%   10   20   30   40   50   60   70   80   90   100%\n')
-            f.write('|----|----|----|----|----|----|----|----|----|----|\n\n')
-            
-            f.close()
-            
-        with open(self.chunk.logFile, 'r') as f:
-            content = f.read()
-            self.progressBarPosition = content.rfind('\n')
-            
-            f.close()
+                f.write((message+'\n').encode('utf-8'))
+            f.write(b'0%   10   20   30   40   50   60   70   80   90   100%\n')
+            f.write(b'|----|----|----|----|----|----|----|----|----|----|\n')
+            # reserve the progress bar line, filled in place by updateProgressBar
+            self.progressBarPosition = f.tell()
+            f.write(b' ' * 51 + b'\n')
 
     def updateProgressBar(self, value):
         assert self.progressBar
         assert value <= self.progressEnd
 
+        self.progressWriter.update(value)
         tics = round((value/self.progressEnd)*51)
+        if tics <= self.currentProgressTics:
+            return
 
-        with open(self.chunk.logFile, 'r+') as f:
-            text = f.read()
-            for i in range(tics-self.currentProgressTics):
-                text = text[:self.progressBarPosition]+'*'+text[self.progressBarPosition:]
-            f.seek(0)
-            f.write(text)
-            f.close()
+        # only write the new tics in the reserved progress bar line
+        with open(self.chunk.logFile, 'r+b') as f:
+            f.seek(self.progressBarPosition + self.currentProgressTics)
+            f.write(b'*' * (tics - self.currentProgressTics))
 
         self.currentProgressTics = tics
 
@@ -247,8 +269,11 @@ class NodeChunk(BaseObject):
         self.logManager = LogManager(self)
         self._status = StatusData(node.name, node.nodeType, node.packageName, node.packageVersion)
         self.statistics = stats.Statistics()
+        self.progressReader = ProgressReader()
         self.statusFileLastModTime = -1
+        self._statusFileCacheKey = None  # (path, inode, mtime, size) of the last loaded status file
         self._subprocess = None
+        self.gpuDevice = None  # GpuDevice the chunk is placed on by the local computation, None for all devices
         # notify update in filepaths when node's internal folder changes
         self.node.internalFolderChanged.connect(self.nodeFolderChanged)
 
@@ -282,16 +307,39 @@ class NodeChunk(BaseObject):
         Update node status based on status file content/existence.
         """
         statusFile = self.statusFile
+        try:
+            fileStat = os.stat(statusFile)
+        except OSError:
+            fileStat = None
+        self.setStatusFromCache(fileStat, loadStatusFile(statusFile) if fileStat else None)
+
+    def isStatusFileModified(self, fileStat):
+        """
+        Whether the status file has been modified since it was last loaded (see statusFileCacheKey).
+
+        Args:
+            fileStat (os.stat_result): the current stat of the status file
+        """
+        return self._statusFileCacheKey != statusFileCacheKey(self.statusFile, fileStat)
+
+    def setStatusFromCache(self, fileStat, statusData):
+        """
+        Update node status from already loaded status file content.
+
+        Args:
+            fileStat (os.stat_result): the stat of the status file (None if it does not exist)
+            statusData (dict): the content of the status file (None if it does not exist)
+        """
         oldStatus = self._status.status
         # No status file => reset status to Status.None
-        if not os.path.exists(statusFile):
+        if fileStat is None or statusData is None:
             self.statusFileLastModTime = -1
+            self._statusFileCacheKey = None
             self._status.reset()
         else:
-            with open(statusFile, 'r') as jsonFile:
-                statusData = json.load(jsonFile)
             self._status.fromDict(statusData)
-            self.statusFileLastModTime = os.path.getmtime(statusFile)
+            self.statusFileLastModTime = fileStat.st_mtime
+            self._statusFileCacheKey = statusFileCacheKey(self.statusFile, fileStat)
         if oldStatus != self._status.status:
             self.statusChanged.emit()
 
@@ -309,6 +357,11 @@ class NodeChunk(BaseObject):
         else:
             return os.path.join(self.node.graph.cacheDir, self.node.internalFolder, str(self.index) + '.statistics')
 
+    @property
+    def previousStatisticsFile(self):
+        """ Statistics of the previous computation of this chunk, kept for comparison. """
+        return self.statisticsFile + '.previous'
+
     @property
     def logFile(self):
         if self.range.blockSize == 0:
@@ -316,6 +369,21 @@ class NodeChunk(BaseObject):
         else:
             return os.path.join(self.node.graph.cacheDir, self.node.internalFolder, str(self.index) + '.log')
 
+    @property
+    def progressFile(self):
+        if self.range.blockSize == 0:
+            return os.path.join(self.node.graph.cacheDir, self.node.internalFolder, 'progress')
+        else:
+            return os.path.join(self.node.graph.cacheDir, self.node.internalFolder, str(self.index) + '.progress')
+
+    def updateProgressFromCache(self):
+        """
+        Update progress from the content appended to the progress file since the last update.
+        """
+        self.progressReader.setFilepath(self.progressFile)
+        if self.progressReader.read():
+            self.progressChanged.emit()
+
     def saveStatusFile(self):
         """
         Write node status on disk.
@@ -389,6 +457,9 @@ class NodeChunk(BaseObject):
         self._status.initStartCompute()
         startTime = time.time()
         self.upgradeStatusTo(Status.RUNNING)
+        # keep statistics of the previous computation
+        if os.path.exists(self.statisticsFile):
+            renameWritingToFinalPath(self.statisticsFile, self.previousStatisticsFile)
         self.statThread = stats.StatisticsThread(self)
         self.statThread.start()
         try:
@@ -425,11 +496,17 @@ class NodeChunk(BaseObject):
     execModeNameChanged = Signal()
     execModeName = Property(str, execModeName.fget, notify=execModeNameChanged)
     statisticsChanged = Signal()
+    progressChanged = Signal()
+    progress = Property(float, lambda self: self.progressReader.progress, notify=progressChanged)
+    eta = Property(float, lambda self: self.progressReader.eta, notify=progressChanged)
+    progressLabel = Property(str, lambda self: self.progressReader.label, notify=progressChanged)
 
     nodeFolderChanged = Signal()
     statusFile = Property(str, statusFile.fget, notify=nodeFolderChanged)
     logFile = Property(str, logFile.fget, notify=nodeFolderChanged)
     statisticsFile = Property(str, statisticsFile.fget, notify=nodeFolderChanged)
+    previousStatisticsFile = Property(str, previousStatisticsFile.fget, notify=nodeFolderChanged)
+    progressFile = Property(str, progressFile.fget, notify=nodeFolderChanged)
 
     nodeName = Property(str, lambda self: self.node.name, constant=True)
     statusNodeName = Property(str, lambda self: self._status.nodeName, constant=True)
@@ -616,18 +693,32 @@ class BaseNode(BaseObject):
             uidAttributes.sort()
             self._uids[uidIndex] = hashValue(uidAttributes)
 
-    def _buildCmdVars(self):
+    @staticmethod
+    def _setCmdVar(cmdVars, name, value, group):
+        """ Set the command line variables of the argument 'name' with 'value' (as written on the command line,
+        None to remove the argument), adding it to its 'group'. """
+        if value is None:
+            cmdVars[name] = ''
+            cmdVars[name + 'Value'] = ''
+            return
+        cmdVars[name] = '--{name} {value}'.format(name=name, value=value)
+        cmdVars[name + 'Value'] = str(value)
+        if value:
+            cmdVars[group] = cmdVars.get(group, '') + ' ' + cmdVars[name]
+
+    def _buildInputCmdVars(self, cmdVars, overrides=None):
+        """ Add the command variables of the input attributes to 'cmdVars', 'overrides' replacing their values
+        (see getCmdVars). """
+        overrides = overrides or {}
+
         def _buildAttributeCmdVars(cmdVars, name, attr):
-            if attr.enabled:
+            # overridden arguments are passed even if their attribute is disabled
+            if attr.enabled or name in overrides:
                 group = attr.attributeDesc.group(attr.node) if isinstance(attr.attributeDesc.group, types.FunctionType) else attr.attributeDesc.group
                 if group is not None:
                     # if there is a valid command line "group"
-                    v = attr.getValueStr()
-                    cmdVars[name] = '--{name} {value}'.format(name=name, value=v)
-                    cmdVars[name + 'Value'] = str(v)
-
-                    if v:
-                        cmdVars[group] = cmdVars.get(group, '') + ' ' + cmdVars[name]
+                    cmdVars.setdefault(group, '')
+                    self._setCmdVar(cmdVars, name, overrides[name] if name in overrides else attr.getValueStr(), group)
                 elif isinstance(attr, GroupAttribute):
                     assert isinstance(attr.value, DictModel)
                     # if the GroupAttribute is not set in a single command line argument,
@@ -635,15 +726,18 @@ class BaseNode(BaseObject):
                     for v in attr._value:
                         _buildAttributeCmdVars(cmdVars, v.name, v)
 
+        for name, attr in self._attributes.objects.items():
+            if attr.isOutput:
+                continue  # skip outputs
+            _buildAttributeCmdVars(cmdVars, name, attr)
+
+    def _buildCmdVars(self):
         """ Generate command variables using input attributes and resolved output attributes names and values. """
         for uidIndex, value in self._uids.items():
             self._cmdVars['uid{}'.format(uidIndex)] = value
 
         # Evaluate input params
-        for name, attr in self._attributes.objects.items():
-            if attr.isOutput:
-                continue  # skip outputs
-            _buildAttributeCmdVars(self._cmdVars, name, attr)
+        self._buildInputCmdVars(self._cmdVars)
 
         # For updating output attributes invalidation values
         cmdVarsNoCache = self._cmdVars.copy()
@@ -666,14 +760,32 @@ class BaseNode(BaseObject):
                 logging.warning('Invalid expression with missing key on "{nodeName}.{attrName}" with value "{defaultValue}".\nError: {err}'.format(nodeName=self.name, attrName=attr.name, defaultValue=defaultValue, err=str(e)))
             except ValueError as e:
                 logging.warning('Invalid expression value on "{nodeName}.{attrName}" with value "{defaultValue}".\nError: {err}'.format(nodeName=self.name, attrName=attr.name, defaultValue=defaultValue, err=str(e)))
-            v = attr.getValueStr()
+            self._setCmdVar(self._cmdVars, name, attr.getValueStr(), attr.attributeDesc.group)
 
-            self._cmdVars[name] = '--{name} {value}'.format(name=name, value=v)
-            self._cmdVars[name + 'Value'] = str(v)
+    def getCmdVars(self, overrides=None):
+        """
+        Get the command variables of the node.
+
+        Args:
+            overrides (dict): values replacing the ones of attributes (name -> value as written on the command line,
+                              None to remove the argument), e.g. to compute a chunk on a part of the input.
+                              They are applied to the variables of the attributes and of their groups (e.g. allParams).
 
-            if v:
-                self._cmdVars[attr.attributeDesc.group] = self._cmdVars.get(attr.attributeDesc.group, '') + \
-                                                          ' ' + self._cmdVars[name]
+        Returns:
+            dict: the command variables
+        """
+        if not overrides:
+            return self._cmdVars
+        cmdVars = {name: value for name, value in self._cmdVars.items() if name == 'cache' or name == 'nodeType'
+                   or name.startswith('uid')}
+        self._buildInputCmdVars(cmdVars, overrides)
+        for name, attr in self._attributes.objects.items():
+            if attr.isInput or not isinstance(attr.attributeDesc, desc.File):
+                continue
+            cmdVars.setdefault(attr.attributeDesc.group, '')
+            self._setCmdVar(cmdVars, name, overrides[name] if name in overrides else attr.getValueStr(),
+                            attr.attributeDesc.group)
+        return cmdVars
 
     @property
     def isParallelized(self):
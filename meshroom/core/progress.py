@@ -0,0 +1,184 @@
+import json
+import logging
+import os
+import time
+
+
+class ProgressWriter:
+    """
+    Append-only progress channel of a NodeChunk.
+
+    Each progress update is written as one JSON line:
+        {"time": <timestamp>, "value": <value>, "total": <total>, "label": <label>}
+    so that the file can be tailed by a ProgressReader at a cost proportional to new updates only.
+    """
+    def __init__(self, filepath):
+        self.filepath = filepath
+        self.value = 0
+        self.total = 0
+        self.label = ''
+        folder = os.path.dirname(filepath)
+        if folder and not os.path.exists(folder):
+            os.makedirs(folder)
+        # clear progress of a previous computation
+        open(self.filepath, 'w').close()
+
+    def begin(self, total, label=''):
+        """ Start a new progress sequence of 'total' steps. """
+        self.total = total
+        self.label = label
+        self.value = 0
+        self._write()
+
+    def update(self, value):
+        """ Set the current progress value (only written if it has changed). """
+        value = min(value, self.total)
+        if value == self.value:
+            return
+        self.value = value
+        self._write()
+
+    def _write(self):
+        record = {"time": time.time(), "value": self.value, "total": self.total, "label": self.label}
+        with open(self.filepath, 'a') as f:
+            f.write(json.dumps(record) + '\n')
+
+
+class ProgressReader:
+    """
+    Incremental reader of a progress channel written by a ProgressWriter.
+    Only the bytes appended since the previous read are read and parsed.
+    """
+    def __init__(self, filepath=''):
+        self.filepath = filepath
+        self.reset()
+
+    def reset(self):
+        self._offset = 0
+        self._pending = b''
+        self.value = 0
+        self.total = 0
+        self.label = ''
+        self.startTime = 0
+        self.lastTime = 0
+
+    def setFilepath(self, filepath):
+        if filepath == self.filepath:
+            return
+        self.filepath = filepath
+        self.reset()
+
+    @property
+    def progress(self):
+        """ Progress of the current sequence in [0, 1], -1 if unknown. """
+        if self.total <= 0:
+            return -1.0
+        return float(self.value) / self.total
+
+    @property
+    def eta(self):
+        """ Estimated remaining time (in seconds) of the current sequence, -1 if unknown. """
+        progress = self.progress
+        if progress <= 0 or progress >= 1:
+            return -1.0
+        elapsed = self.lastTime - self.startTime
+        return elapsed * (1.0 - progress) / progress
+
+    def read(self):
+        """
+        Read and parse the records appended since the previous read.
+
+        Returns:
+            bool: whether the progress has changed
+        """
+        try:
+            size = os.path.getsize(self.filepath)
+        except OSError:
+            # file has been removed: progress is unknown
+            changed = self.total != 0
+            self.reset()
+            return changed
+        if size < self._offset:
+            # file has been truncated (new computation): restart from the beginning
+            self.reset()
+        if size == self._offset:
+            return False
+
+        with open(self.filepath, 'rb') as f:
+            f.seek(self._offset)
+            data = self._pending + f.read(size - self._offset)
+        self._offset = size
+        lines = data.split(b'\n')
+        # keep incomplete trailing line for next read
+        self._pending = lines.pop()
+
+        changed = False
+        for line in lines:
+            if not line.strip():
+                continue
+            try:
+                record = json.loads(line.decode('utf-8'))
+            except ValueError:
+                logging.debug('ProgressReader: invalid record in "{}": {}'.format(self.filepath, line))
+                continue
+            self._addRecord(record)
+            changed = True
+        return changed
+
+    def _addRecord(self, record):
+        value = record.get('value', 0)
+        total = record.get('total', 0)
+        label = record.get('label', '')
+        recordTime = record.get('time', 0)
+        if total != self.total or label != self.label or value < self.value:
+            # new progress sequence
+            self.startTime = recordTime
+        self.value = value
+        self.total = total
+        self.label = label
+        self.lastTime = recordTime
+
+
+class TextProgressBarParser:
+    """
+    Detect textual progress bars in a process output and forward their progress to a ProgressWriter.
+
+    Expected format (as displayed by AliceVision command lines):
+        0%   10   20   30   40   50   60   70   80   90   100%
+        |----|----|----|----|----|----|----|----|----|----|
+        ***************************************************
+    """
+    header = b'0%   10   20   30   40   50   60   70   80   90   100%'
+    ruler = b'|----|----|----|----|----|----|----|----|----|----|'
+    character = b'*'
+    total = 51
+
+    def __init__(self, progressWriter):
+        self.progressWriter = progressWriter
+        self._line = b''
+        self._previousLine = b''
+        self._inProgressBar = False
+        self._value = 0
+
+    def feed(self, data):
+        """ Parse a new block of output bytes. """
+        for part in data.splitlines(True):
+            self._line += part
+            if self._inProgressBar:
+                self._value += part.count(self.character)
+                self.progressWriter.update(self._value)
+            if self._line.endswith((b'\n', b'\r')):
+                self._endLine()
+
+    def _endLine(self):
+        line = self._line.strip()
+        self._line = b''
+        if self._inProgressBar and line:
+            # end of progress bar line
+            self._inProgressBar = False
+        elif line == self.ruler and self._previousLine == self.header:
+            self._inProgressBar = True
+            self._value = 0
+            self.progressWriter.begin(self.total)
+        if line:
+            self._previousLine = line
@@ -0,0 +1,163 @@
+#!/usr/bin/env python
+# coding:utf-8
+"""
+Loading of the camera related content of SfMData JSON files (views, poses and intrinsics).
+
+Landmarks ('structure') can represent most of the size of these files and are not needed to display cameras:
+top-level values are decoded one by one while reading the file, and reading stops as soon as all the
+needed values have been decoded.
+"""
+import json
+import os
+from collections import OrderedDict
+from threading import Lock
+
+
+# top-level keys of SfMData JSON files needed to get the cameras
+_cameraKeys = ('views', 'poses', 'intrinsics')
+
+
+class _JsonObjectReader:
+    """ Decode top-level values of a JSON object one by one, reading the file progressively. """
+    chunkSize = 4 * 1024 * 1024
+
+    def __init__(self, f):
+        self._file = f
+        self._buffer = ''
+        self._pos = 0
+        self._eof = False
+        self._decoder = json.JSONDecoder()
+
+    def _readMore(self, size):
+        if self._eof:
+            return False
+        data = self._file.read(size)
+        if not data:
+            self._eof = True
+            return False
+        # drop decoded content
+        self._buffer = self._buffer[self._pos:] + data
+        self._pos = 0
+        return True
+
+    def _skipWhitespaces(self):
+        while True:
+            while self._pos < len(self._buffer) and self._buffer[self._pos] in ' \t\n\r':
+                self._pos += 1
+            if self._pos < len(self._buffer) or not self._readMore(self.chunkSize):
+                return
+
+    def _expect(self, characters):
+        self._skipWhitespaces()
+        c = self._buffer[self._pos:self._pos + 1]
+        if c not in characters or not c:
+            raise ValueError("Invalid JSON object: expected one of '{}' but got '{}'".format(characters, c))
+        self._pos += 1
+        return c
+
+    def _decodeValue(self):
+        self._skipWhitespaces()
+        size = self.chunkSize
+        while True:
+            try:
+                value, end = self._decoder.raw_decode(self._buffer, self._pos)
+                # a number at the end of the buffer might be truncated
+                if end < len(self._buffer) or self._eof:
+                    self._pos = end
+                    return value
+            except ValueError:
+                if self._eof:
+                    raise
+            # value is incomplete: read more (increasingly large chunks to limit decoding attempts)
+            if not self._readMore(size):
+                continue
+            size *= 2
+
+    def items(self):
+        """ Iterate over the (key, value) pairs of the object (values being decoded lazily). """
+        self._expect('{')
+        self._skipWhitespaces()
+        if self._buffer[self._pos:self._pos + 1] == '}':
+            return
+        while True:
+            key = self._decodeValue()
+            self._expect(':')
+            yield key, self._decodeValue
+            if self._expect(',}') == '}':
+                return
+
+
+def parseSfMJsonFile(sfmJsonFile):
+    """
+    Parse the SfM Json file and return views, poses and intrinsics as three dicts with viewId, poseId and intrinsicId as keys.
+    """
+    if not os.path.exists(sfmJsonFile):
+        return {}, {}, {}
+
+    report = {}
+    with open(sfmJsonFile) as jsonFile:
+        for key, decodeValue in _JsonObjectReader(jsonFile).items():
+            if key in _cameraKeys:
+                report[key] = decodeValue()
+                if len(report) == len(_cameraKeys):
+                    # skip the rest of the file (structure)
+                    break
+            else:
+                # value has to be decoded to get to the next key
+                decodeValue()
+
+    views = dict()
+    poses = dict()
+    intrinsics = dict()
+
+    for view in report.get('views', []):
+        views[view['viewId']] = view
+
+    for pose in report.get('poses', []):
+        poses[pose['poseId']] = pose['pose']
+
+    for intrinsic in report.get('intrinsics', []):
+        intrinsics[intrinsic['intrinsicId']] = intrinsic
+
+    return views, poses, intrinsics
+
+
+class SfMDataCache:
+    """
+    Cache of parsed SfM Json files (see parseSfMJsonFile), identified by their path and modification time.
+    Can be used from several threads.
+    """
+    def __init__(self, maxSize=4):
+        self.maxSize = maxSize
+        self._cache = OrderedDict()
+        self._lock = Lock()
+
+    @staticmethod
+    def _key(sfmJsonFile):
+        try:
+            return sfmJsonFile, os.path.getmtime(sfmJsonFile)
+        except OSError:
+            return sfmJsonFile, None
+
+    def get(self, sfmJsonFile):
+        """ Get the cached parsing result of 'sfmJsonFile' if it is up-to-date, None otherwise. """
+        key = self._key(sfmJsonFile)
+        with self._lock:
+            result = self._cache.pop(key, None)
+            if result is not None:
+                # most recently used
+                self._cache[key] = result
+            return result
+
+    def load(self, sfmJsonFile):
+        """ Get the parsing result of 'sfmJsonFile', from the cache if it is up-to-date. """
+        result = self.get(sfmJsonFile)
+        if result is not None:
+            return result
+        key = self._key(sfmJsonFile)
+        result = parseSfMJsonFile(sfmJsonFile)
+        with self._lock:
+            self._cache[key] = result
+            while len(self._cache) > self.maxSize:
+                self._cache.popitem(last=False)
+        return result
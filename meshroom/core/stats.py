@@ -303,3 +303,59 @@ class StatisticsThread(threading.Thread):
     def stopRequest(self):
         """ Request the thread to exit as soon as possible. """
         self._stopFlag.set()
+
+
+class DownsampledCurve:
+    """
+    Display points of a statistics curve that grows over time.
+
+    Consecutive samples are averaged by windows of 'stride' samples so that the number of points
+    stays under 'maxPoints': new points only need to be appended as new samples arrive, except when
+    'maxPoints' is exceeded, where the window size is doubled and all points are recomputed.
+    """
+    def __init__(self, maxPoints=500):
+        self.maxPoints = maxPoints
+        self.reset()
+
+    def reset(self):
+        self.samples = []
+        self.stride = 1
+        # list of (sample index, value)
+        self.points = []
+
+    def update(self, samples):
+        """
+        Update the curve with all its known samples (only the new ones are processed).
+
+        Args:
+            samples (list): all the samples of the curve (values convertible to float)
+
+        Returns:
+            tuple: (rebuilt, newPoints) where 'rebuilt' is True if all points have been recomputed
+                   (see 'points') and 'newPoints' the points appended otherwise
+        """
+        rebuilt = False
+        if len(samples) < len(self.samples):
+            # new computation
+            self.reset()
+            rebuilt = True
+        previousCount = len(self.samples)
+        self.samples.extend(float(v) for v in samples[previousCount:])
+
+        firstNewPoint = len(self.points)
+        self._computePoints(firstNewPoint * self.stride)
+        while len(self.points) > self.maxPoints:
+            self.stride *= 2
+            self.points = []
+            self._computePoints(0)
+            rebuilt = True
+        if rebuilt:
+            return True, []
+        return False, self.points[firstNewPoint:]
+
+    def _computePoints(self, start):
+        """ Append the points of all complete windows starting at sample index 'start'. """
+        stride = self.stride
+        samples = self.samples
+        for i in range(start, len(samples) - stride + 1, stride):
+            self.points.append((i, sum(samples[i:i + stride]) / stride))
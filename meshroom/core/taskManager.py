@@ -1,9 +1,12 @@
 import logging
-from threading import Thread
+from multiprocessing.pool import ThreadPool
+from threading import Lock, Thread
 from enum import Enum
 
 import meshroom
 from meshroom.common import BaseObject, DictModel, Property, Signal, Slot
+from meshroom.core import desc
+from meshroom.core.gpuDevices import availableDevices, resetDevices, DevicePool
 from meshroom.core.node import Status
 import meshroom.core.graph
 
@@ -28,6 +31,8 @@ class TaskThread(Thread):
         self._state = State.IDLE
         self._manager = manager
         self.forceCompute = False
+        # chunks computed concurrently (see _processChunksOnDevices) handle their errors one at a time
+        self._errorLock = Lock()
 
     def isRunning(self):
         return self._state == State.RUNNING
@@ -35,6 +40,8 @@ class TaskThread(Thread):
     def run(self):
         """ Consume compute tasks. """
         self._state = State.RUNNING
+        # the devices may have changed since the last computation (environment, drivers...)
+        resetDevices()
 
         stopAndRestart = False
 
@@ -50,34 +57,18 @@ class TaskThread(Thread):
             except TypeError:
                 continue
 
-            for cId, chunk in enumerate(node.chunks):
-                if chunk.isFinishedOrRunning() or not self.isRunning():
-                    continue
-
-                if multiChunks:
-                    logging.info('[{node}/{nbNodes}]({chunk}/{nbChunks}) {nodeName}'.format(
-                        node=nId+1, nbNodes=len(self._manager._nodesToProcess),
-                        chunk=cId+1, nbChunks=len(node.chunks), nodeName=node.nodeType))
-                else:
-                    logging.info('[{node}/{nbNodes}] {nodeName}'.format(
-                        node=nId+1, nbNodes=len(self._manager._nodesToProcess), nodeName=node.nodeType))
-                try:
-                    chunk.process(self.forceCompute)
-                except Exception as e:
-                    if chunk.isStopped():
+            # chunks of GPU nodes are computed concurrently on multi-GPU machines, one per device
+            devices = availableDevices() if multiChunks and node.nodeDesc.gpu != desc.Level.NONE else []
+            if len(devices) > 1:
+                stopAndRestart = not self._processChunksOnDevices(nId, node, devices)
+            else:
+                for cId, chunk in enumerate(node.chunks):
+                    if chunk.isFinishedOrRunning() or not self.isRunning():
+                        continue
+                    self._logChunk(nId, node, cId)
+                    if not self._processChunk(node, chunk):
                         stopAndRestart = True
                         break
-                    else:
-                        logging.error("Error on node computation: {}".format(e))
-                        nodesToRemove, _ = self._manager._graph.dfsOnDiscover(startNodes=[node], reverse=True)
-                        # remove following nodes from the task queue
-                        for n in nodesToRemove[1:]:  # exclude current node
-                            try:
-                                self._manager._nodesToProcess.remove(n)
-                            except ValueError:
-                                # Node already removed (for instance a global clear of _nodesToProcess)
-                                pass
-                            n.clearSubmittedChunks()
 
             if stopAndRestart:
                 break
@@ -89,6 +80,75 @@ class TaskThread(Thread):
             self._manager._nodesToProcess = []
             self._state = State.DEAD
 
+    def _logChunk(self, nId, node, cId, device=None):
+        onDevice = ' (GPU {})'.format(device.id) if device else ''
+        if len(node.chunks) > 1:
+            logging.info('[{node}/{nbNodes}]({chunk}/{nbChunks}) {nodeName}{onDevice}'.format(
+                node=nId+1, nbNodes=len(self._manager._nodesToProcess),
+                chunk=cId+1, nbChunks=len(node.chunks), nodeName=node.nodeType, onDevice=onDevice))
+        else:
+            logging.info('[{node}/{nbNodes}] {nodeName}{onDevice}'.format(
+                node=nId+1, nbNodes=len(self._manager._nodesToProcess), nodeName=node.nodeType, onDevice=onDevice))
+
+    def _processChunk(self, node, chunk):
+        """
+        Compute 'chunk' of 'node'. On error, the nodes depending on 'node' are removed from the tasks.
+
+        Returns:
+            bool: False if the computation has been stopped
+        """
+        try:
+            chunk.process(self.forceCompute)
+        except Exception as e:
+            if chunk.isStopped():
+                return False
+            logging.error("Error on node computation: {}".format(e))
+            with self._errorLock:
+                nodesToRemove, _ = self._manager._graph.dfsOnDiscover(startNodes=[node], reverse=True)
+                # remove following nodes from the task queue
+                for n in nodesToRemove[1:]:  # exclude current node
+                    try:
+                        self._manager._nodesToProcess.remove(n)
+                    except ValueError:
+                        # Node already removed (for instance a global clear of _nodesToProcess)
+                        pass
+                    n.clearSubmittedChunks()
+        return True
+
+    def _processChunksOnDevices(self, nId, node, devices):
+        """
+        Compute the chunks of 'node' concurrently, each one on its own device of 'devices'.
+
+        Returns:
+            bool: False if the computation has been stopped
+        """
+        pool = DevicePool(devices)
+        stopped = []
+
+        def processOnDevice(cId):
+            chunk = node.chunks[cId]
+            if stopped or chunk.isFinishedOrRunning() or not self.isRunning():
+                return
+            device = pool.acquire()
+            try:
+                if stopped or not self.isRunning():
+                    return
+                self._logChunk(nId, node, cId, device)
+                chunk.gpuDevice = device
+                if not self._processChunk(node, chunk):
+                    stopped.append(chunk)
+            finally:
+                chunk.gpuDevice = None
+                pool.release(device)
+
+        threads = ThreadPool(len(devices))
+        try:
+            threads.map(processOnDevice, range(len(node.chunks)))
+        finally:
+            threads.close()
+            threads.join()
+        return not stopped
+
 
 class TaskManager(BaseObject):
     """
@@ -0,0 +1,301 @@
+#!/usr/bin/env python
+# coding:utf-8
+import os
+from array import array
+from bisect import bisect_right
+from collections import OrderedDict
+
+
+class TextFileIndex:
+    """
+    Incremental line index of a text file that may grow over time (e.g. the log of a running process).
+
+    Only the tail of the file is indexed at first, older parts are indexed on demand (see 'loadOlder').
+    Each 'update' only reads the bytes appended since the previous one, and the last 'rewriteCheckSize' bytes
+    already indexed to detect lines rewritten in place (e.g. a progress bar filled in the reserved line of a log).
+    Lines are stored as byte offsets, their content is read from the file when requested.
+    """
+    blockSize = 1024 * 1024
+    lineCacheSize = 1024
+    rewriteCheckSize = 64 * 1024
+
+    def __init__(self, filepath='', tailSize=blockSize):
+        self.filepath = filepath
+        self.tailSize = tailSize
+        self.reset()
+
+    def reset(self):
+        # byte offset of the start of each indexed line
+        self._lineOffsets = array('q')
+        # byte offset of the first indexed line
+        self._firstOffset = 0
+        # number of bytes of the file that have been read
+        self._offset = 0
+        # whether the next byte to read starts a new line
+        self._atLineStart = True
+        self._initialized = False
+        self._lineCache = OrderedDict()
+        # last bytes read, compared to the file content to detect rewritten lines
+        self._tail = b''
+
+    def setFilepath(self, filepath):
+        if filepath == self.filepath:
+            return
+        self.filepath = filepath
+        self.reset()
+
+    @property
+    def lineCount(self):
+        return len(self._lineOffsets)
+
+    @property
+    def hasOlderLines(self):
+        """ Whether the beginning of the file has not been indexed yet. """
+        return self._firstOffset > 0
+
+    def update(self):
+        """
+        Index the lines appended to the file since the previous update, and detect the lines rewritten in place.
+
+        Returns:
+            tuple: (reset, firstModifiedLine) where 'reset' is True if the index has been rebuilt
+                   (new or truncated file) and 'firstModifiedLine' is the index of the first new or modified line,
+                   or None if nothing has changed
+        """
+        try:
+            size = os.path.getsize(self.filepath)
+        except OSError:
+            if not self._initialized and not self._lineOffsets:
+                return None
+            self.reset()
+            return True, 0
+
+        reset = False
+        if size < self._offset:
+            # file has been truncated: rebuild index
+            self.reset()
+            reset = True
+        if not self._initialized:
+            self._initialized = True
+            reset = True
+            self._initializeTail(size)
+
+        with open(self.filepath, 'rb') as f:
+            rewrittenLine = self._findRewrittenLine(f)
+            if rewrittenLine == -1:
+                # line endings have been rewritten: rebuild index
+                self.reset()
+                self._initialized = True
+                reset = True
+                self._initializeTail(size)
+                rewrittenLine = None
+            if size == self._offset:
+                if reset:
+                    return True, 0
+                return None if rewrittenLine is None else (False, rewrittenLine)
+
+            previousCount = self.lineCount
+            # last line is modified if it has not been terminated yet
+            firstModifiedLine = previousCount if self._atLineStart else previousCount - 1
+            if rewrittenLine is not None:
+                firstModifiedLine = min(firstModifiedLine, rewrittenLine)
+            f.seek(self._offset)
+            while self._offset < size:
+                data = f.read(min(self.blockSize, size - self._offset))
+                if not data:
+                    break
+                self._indexBlock(data)
+        self._lineCache.pop(previousCount - 1, None)
+        return reset, 0 if reset else firstModifiedLine
+
+    def _findRewrittenLine(self, f):
+        """
+        Compare the last bytes read to the content of the file 'f'.
+
+        Returns:
+            int: the index of the first line rewritten since the previous update, None if unchanged,
+                 -1 if line endings have changed (lines offsets are no longer valid)
+        """
+        if not self._tail:
+            return None
+        start = self._offset - len(self._tail)
+        f.seek(start)
+        data = f.read(len(self._tail))
+        if data == self._tail:
+            return None
+        # lines offsets are still valid if each indexed line still starts after a line ending
+        firstTailLine = bisect_right(self._lineOffsets, start)
+        if data.count(b'\n') != self._tail.count(b'\n') or any(
+                data[offset - start - 1:offset - start] != b'\n' for offset in self._lineOffsets[firstTailLine:]):
+            return -1
+        firstChange = start + len(os.path.commonprefix([data, self._tail]))
+        self._tail = data
+        firstLine = max(0, bisect_right(self._lineOffsets, firstChange) - 1)
+        for index in [i for i in self._lineCache if i >= firstLine]:
+            del self._lineCache[index]
+        return firstLine
+
+    def _initializeTail(self, size):
+        """ Start indexing at the first line beginning in the last 'tailSize' bytes of the file. """
+        start = max(0, size - self.tailSize)
+        if start > 0:
+            with open(self.filepath, 'rb') as f:
+                f.seek(start - 1)
+                # skip the end of the line in progress at 'start' (if it is terminated)
+                if f.readline().endswith(b'\n'):
+                    start = f.tell()
+        self._firstOffset = self._offset = start
+
+    def _indexBlock(self, data):
+        """ Index a block of bytes read at the current offset. """
+        offsets = self._lineOffsets
+        if self._atLineStart:
+            offsets.append(self._offset)
+        end = len(data)
+        find = data.find
+        pos = find(b'\n')
+        while pos != -1 and pos + 1 < end:
+            offsets.append(self._offset + pos + 1)
+            pos = find(b'\n', pos + 1)
+        self._atLineStart = data.endswith(b'\n')
+        self._offset += end
+        self._tail = (self._tail + data[-self.rewriteCheckSize:])[-self.rewriteCheckSize:]
+
+    def loadOlder(self, maxBytes=blockSize):
+        """
+        Index (at least) the line preceding the first indexed one, reading up to 'maxBytes' before it.
+
+        Returns:
+            int: the number of lines inserted at the beginning of the index
+        """
+        return self.insertOlderLines(self.readOlderLines(maxBytes))
+
+    def readOlderLines(self, maxBytes=blockSize):
+        """
+        Read the offsets of (at least) the line preceding the first indexed one, reading up to 'maxBytes' before it,
+        without inserting them in the index (see insertOlderLines).
+
+        Returns:
+            array: the offsets of the older lines
+        """
+        if self._firstOffset <= 0:
+            return array('q')
+        end = self._firstOffset
+        with open(self.filepath, 'rb') as f:
+            while True:
+                start = max(0, end - maxBytes)
+                f.seek(start)
+                data = f.read(end - start)
+                starts = array('q')
+                if start == 0:
+                    starts.append(0)
+                pos = data.find(b'\n')
+                while pos != -1 and start + pos + 1 < end:
+                    starts.append(start + pos + 1)
+                    pos = data.find(b'\n', pos + 1)
+                if starts:
+                    break
+                # no complete line in this block: read a larger one
+                maxBytes *= 2
+        return starts
+
+    def insertOlderLines(self, starts):
+        """
+        Insert the offsets of older lines read by readOlderLines at the beginning of the index.
+
+        Returns:
+            int: the number of inserted lines
+        """
+        if not starts:
+            return 0
+        self._lineOffsets = starts + self._lineOffsets
+        self._firstOffset = starts[0]
+        # lines indices have changed
+        self._lineCache.clear()
+        return len(starts)
+
+    def _lineRange(self, index):
+        start = self._lineOffsets[index]
+        end = self._lineOffsets[index + 1] if index + 1 < len(self._lineOffsets) else self._offset
+        return start, end
+
+    def line(self, index):
+        """ Get the text of the line at 'index' (without line ending). """
+        text = self._lineCache.get(index)
+        if text is not None:
+            return text
+        start, end = self._lineRange(index)
+        try:
+            with open(self.filepath, 'rb') as f:
+                f.seek(start)
+                data = f.read(end - start)
+        except (IOError, OSError):
+            return ''
+        text = data.rstrip(b'\r\n').decode('utf-8', 'replace')
+        self._lineCache[index] = text
+        if len(self._lineCache) > self.lineCacheSize:
+            self._lineCache.popitem(last=False)
+        return text
+
+    def text(self, first, last):
+        """ Get the text from line 'first' to line 'last' (included). """
+        if self.lineCount == 0 or first > last:
+            return ''
+        start = self._lineRange(first)[0]
+        end = self._lineRange(last)[1]
+        with open(self.filepath, 'rb') as f:
+            f.seek(start)
+            return f.read(end - start).decode('utf-8', 'replace')
+
+    def find(self, text, fromLine=0, backward=False, caseSensitive=False):
+        """
+        Find the next line containing 'text' in the indexed part of the file.
+
+        Args:
+            text (str): the text to search
+            fromLine (int): the line to start from (included)
+            backward (bool): whether to search towards the beginning of the file
+            caseSensitive (bool): whether the search is case sensitive
+
+        Returns:
+            int: the index of the matching line or -1 if not found
+        """
+        if not text or self.lineCount == 0:
+            return -1
+        pattern = text.encode('utf-8')
+        if not caseSensitive:
+            pattern = pattern.lower()
+        fromLine = max(0, min(fromLine, self.lineCount - 1))
+        overlap = len(pattern) - 1
+        # blocks must be larger than the pattern to progress
+        blockSize = max(self.blockSize, 2 * len(pattern))
+
+        with open(self.filepath, 'rb') as f:
+            if not backward:
+                pos = self._lineOffsets[fromLine]
+                while pos < self._offset:
+                    f.seek(pos)
+                    data = f.read(min(blockSize, self._offset - pos))
+                    if not caseSensitive:
+                        data = data.lower()
+                    match = data.find(pattern)
+                    if match != -1:
+                        return bisect_right(self._lineOffsets, pos + match) - 1
+                    if pos + len(data) >= self._offset:
+                        break
+                    pos += max(1, len(data) - overlap)
+            else:
+                end = self._lineRange(fromLine)[1]
+                while end > self._firstOffset:
+                    start = max(self._firstOffset, end - blockSize)
+                    f.seek(start)
+                    data = f.read(end - start)
+                    if not caseSensitive:
+                        data = data.lower()
+                    match = data.rfind(pattern)
+                    if match != -1:
+                        return bisect_right(self._lineOffsets, start + match) - 1
+                    if start == self._firstOffset:
+                        break
+                    end = start + overlap
+        return -1
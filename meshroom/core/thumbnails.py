@@ -0,0 +1,194 @@
+#!/usr/bin/env python
+# coding:utf-8
+"""
+Persistent cache of image thumbnails.
+
+Thumbnails are stored in a cache folder, identified by the path, modification time and size of their source image:
+modified images automatically get a new thumbnail, and 'cleanup' removes the oldest thumbnails
+(including outdated ones) when the cache folder gets too large.
+Thumbnails are created by a pool of threads, using a creation function provided by the caller.
+"""
+import hashlib
+import logging
+import os
+from multiprocessing.pool import ThreadPool
+from threading import Event, Lock
+
+from meshroom.core.fileUtils import removeOldestFiles, replaceFile, temporaryPath
+
+
+class ThumbnailCache:
+    """
+    Cache of image thumbnails created in background threads.
+
+    'request' creates the thumbnail of an image needed right away, 'prefetch' the thumbnails of images that are likely
+    to be needed soon (e.g. next to the visible area of a view): pending prefetches are dropped when no longer wanted.
+    """
+    extension = '.jpg'
+
+    def __init__(self, cacheDir, createThumbnail, maxWorkers=None, maxCacheSize=512 * 1024 * 1024):
+        """
+        Args:
+            cacheDir (str): the folder where thumbnails are stored
+            createThumbnail (callable): function(imagePath, thumbnailPath) writing the thumbnail of an image,
+                                        called in worker threads
+            maxWorkers (int): the number of worker threads (defaults to the number of CPUs)
+            maxCacheSize (int): the size (in bytes) of the cache folder above which 'cleanup' removes thumbnails
+        """
+        self.cacheDir = cacheDir
+        self.maxCacheSize = maxCacheSize
+        self._createThumbnail = createThumbnail
+        self._maxWorkers = maxWorkers
+        self._pool = None
+        self._lock = Lock()
+        # image path -> Event set when the pending thumbnail creation is over (or dropped)
+        self._pending = {}
+        # image path -> functions called when the pending thumbnail creation is over (or dropped)
+        self._callbacks = {}
+        # images whose thumbnail creation has been requested (as opposed to prefetched)
+        self._requested = set()
+        self._prefetched = set()
+
+    def thumbnailPath(self, imagePath):
+        """ Get the path of the thumbnail of 'imagePath' in the cache folder, None if the image does not exist. """
+        try:
+            stat = os.stat(imagePath)
+        except OSError:
+            return None
+        key = u'{}|{}|{}'.format(os.path.abspath(imagePath), stat.st_mtime, stat.st_size).encode('utf-8')
+        digest = hashlib.sha1(key).hexdigest()
+        # split thumbnails in sub-folders to keep folders small
+        return os.path.join(self.cacheDir, digest[:2], digest[2:] + self.extension)
+
+    def cached(self, imagePath):
+        """ Get the path of the up-to-date thumbnail of 'imagePath' if it exists in the cache, None otherwise. """
+        path = self.thumbnailPath(imagePath)
+        return path if path and os.path.isfile(path) else None
+
+    def request(self, imagePath, onDone=None):
+        """
+        Start the creation of the thumbnail of 'imagePath' if it is not cached yet.
+
+        Args:
+            onDone (callable): function called without arguments when the pending creation is over (or dropped),
+                               from a worker thread or 'close' with the cache lock held: it must be short and must
+                               not call the cache. Not called if the thumbnail is already cached.
+
+        Returns:
+            Event: set when the pending thumbnail creation is over, None if the thumbnail is already cached
+        """
+        if self.cached(imagePath):
+            return None
+        with self._lock:
+            self._requested.add(imagePath)
+            done = self._submit(imagePath)
+            if onDone is not None:
+                self._callbacks.setdefault(imagePath, []).append(onDone)
+            return done
+
+    def prefetch(self, imagePaths):
+        """
+        Create the thumbnails of 'imagePaths' if they are not cached yet.
+        Replaces the previous prefetch: its pending thumbnails that are not part of this one are not created.
+        """
+        imagePaths = [p for p in imagePaths if not self.cached(p)]
+        with self._lock:
+            self._prefetched = set(imagePaths)
+            for imagePath in imagePaths:
+                self._submit(imagePath)
+
+    def get(self, imagePath, timeout=None):
+        """
+        Get the path of the thumbnail of 'imagePath', waiting for its creation if needed.
+
+        Args:
+            timeout (float): the maximum time to wait for the creation (in seconds), None to wait until it is over
+
+        Returns:
+            str: the path of the thumbnail, None if it could not be created
+        """
+        done = self.request(imagePath)
+        if done is not None:
+            done.wait(timeout)
+        return self.cached(imagePath)
+
+    def _submit(self, imagePath):
+        # must be called with the lock held
+        done = self._pending.get(imagePath)
+        if done is None:
+            if self._pool is None:
+                self._pool = ThreadPool(self._maxWorkers)
+            done = self._pending[imagePath] = Event()
+            self._pool.apply_async(self._create, (imagePath,))
+        return done
+
+    def _release(self, imagePath):
+        # must be called with the lock held
+        done = self._pending.pop(imagePath, None)
+        if done is not None:
+            done.set()
+        for onDone in self._callbacks.pop(imagePath, []):
+            try:
+                onDone()
+            except Exception as e:
+                logging.warning("Thumbnail callback of '{}' failed: {}".format(imagePath, str(e)))
+
+    def _isWanted(self, imagePath):
+        with self._lock:
+            if imagePath in self._requested or imagePath in self._prefetched:
+                return True
+            # outdated prefetch
+            self._release(imagePath)
+            return False
+
+    def _create(self, imagePath):
+        """ Create the thumbnail of 'imagePath' (called in a worker thread). """
+        if not self._isWanted(imagePath):
+            return
+        try:
+            thumbnailPath = self.thumbnailPath(imagePath)
+            if thumbnailPath and not os.path.isfile(thumbnailPath):
+                folder = os.path.dirname(thumbnailPath)
+                if not os.path.isdir(folder):
+                    try:
+                        os.makedirs(folder)
+                    except OSError:
+                        # created by another thread in the meantime
+                        pass
+                # other threads must never read a partial thumbnail
+                # (several Meshroom instances may share the cache folder)
+                tmpPath = temporaryPath(thumbnailPath)
+                try:
+                    if self._createThumbnail(imagePath, tmpPath):
+                        replaceFile(tmpPath, thumbnailPath)
+                finally:
+                    if os.path.exists(tmpPath):
+                        os.remove(tmpPath)
+        except Exception as e:
+            logging.warning("Failed to create thumbnail of '{}': {}".format(imagePath, str(e)))
+        finally:
+            with self._lock:
+                self._release(imagePath)
+                self._requested.discard(imagePath)
+                self._prefetched.discard(imagePath)
+
+    def cleanup(self):
+        """
+        Remove the oldest thumbnails until the cache folder is smaller than 'maxCacheSize'.
+
+        Returns:
+            int: the number of removed thumbnails
+        """
+        return removeOldestFiles(self.cacheDir, self.maxCacheSize)
+
+    def close(self):
+        """ Drop pending thumbnails and stop the worker threads. Threads waiting for a thumbnail are released. """
+        with self._lock:
+            self._requested.clear()
+            self._prefetched.clear()
+            for imagePath in list(self._pending):
+                self._release(imagePath)
+            pool, self._pool = self._pool, None
+        if pool is not None:
+            pool.terminate()
+            pool.join()
@@ -0,0 +1,174 @@
+#!/usr/bin/env python
+# coding:utf-8
+"""
+Parsed metadata of CameraInit viewpoints.
+
+Viewpoints store the metadata of their image as a JSON string. Metadata are parsed once per string and kept in a
+cache shared by all users (node update hooks, UI), with the commonly used EXIF keys indexed into typed fields.
+Values computed from all the viewpoints of a CameraInit (e.g. the number of exposure brackets) are also cached,
+keyed by the viewpoints content, to be computed once for all the nodes depending on the same CameraInit.
+"""
+import json
+import logging
+from collections import OrderedDict
+
+
+def findMetadata(d, keys, defaultValue):
+    """
+    Get the value of the first of 'keys' found in the metadata dict 'd'.
+    Keys are also matched case-insensitively and without their namespace (e.g. "Exif:FNumber" for "FNumber").
+    """
+    v = None
+    for key in keys:
+        v = d.get(key, None)
+        k = key.lower()
+        if v is not None:
+            return v
+        for dk, dv in d.items():
+            dkm = dk.lower().replace(" ", "")
+            if dkm == key.lower():
+                return dv
+            dkm = dkm.split(":")[-1]
+            dkm = dkm.split("/")[-1]
+            if dkm == k:
+                return dv
+    return defaultValue
+
+
+def _toFloat(value):
+    try:
+        return float(value)
+    except (TypeError, ValueError):
+        return None
+
+
+class ViewpointMetadata(object):
+    """ Metadata of a viewpoint image, with typed values of common EXIF keys. """
+    __slots__ = ('data', 'exposure', 'fNumber', 'shutterSpeed', 'iso', 'make', 'model', 'focalLength',
+                 'bodySerialNumber', 'lensSerialNumber')
+
+    def __init__(self, data):
+        self.data = data
+        fNumber = findMetadata(data, ["FNumber", "Exif:ApertureValue", "ApertureValue", "Aperture"], "")
+        shutterSpeed = findMetadata(data, ["Exif:ShutterSpeedValue", "ShutterSpeedValue", "ShutterSpeed"], "")
+        iso = findMetadata(data, ["Exif:ISOSpeedRatings", "ISOSpeedRatings", "ISO"], "")
+        # raw values identifying the exposure settings of the image
+        self.exposure = (fNumber, shutterSpeed, iso)
+        self.fNumber = _toFloat(fNumber)
+        self.shutterSpeed = _toFloat(shutterSpeed)
+        self.iso = _toFloat(iso)
+        self.make = findMetadata(data, ["Make"], "")
+        self.model = findMetadata(data, ["Model"], "")
+        self.focalLength = _toFloat(findMetadata(data, ["FocalLength"], None))
+        self.bodySerialNumber = findMetadata(data, ["BodySerialNumber"], "")
+        self.lensSerialNumber = findMetadata(data, ["LensSerialNumber"], "")
+
+    @property
+    def hasExposure(self):
+        """ Whether the aperture or the shutter speed of the image is known. """
+        return bool(self.exposure[0] or self.exposure[1])
+
+
+class _Cache(object):
+    """ Bounded dict keeping the most recently added entries. """
+    def __init__(self, maxSize):
+        self.maxSize = maxSize
+        self._entries = OrderedDict()
+
+    def get(self, key):
+        return self._entries.get(key)
+
+    def add(self, key, value):
+        self._entries[key] = value
+        while len(self._entries) > self.maxSize:
+            self._entries.popitem(last=False)
+        return value
+
+    def clear(self):
+        self._entries.clear()
+
+
+# metadata JSON string -> ViewpointMetadata
+_metadataCache = _Cache(100000)
+# viewpoints content -> number of brackets
+_nbBracketsCache = _Cache(16)
+
+
+def parseMetadata(metadataStr):
+    """
+    Get the ViewpointMetadata of the JSON string 'metadataStr' (parsed once and cached).
+
+    Returns:
+        ViewpointMetadata: the metadata, None if 'metadataStr' is empty or invalid
+    """
+    if not metadataStr:
+        return None
+    metadata = _metadataCache.get(metadataStr)
+    if metadata is None:
+        try:
+            metadata = ViewpointMetadata(json.loads(metadataStr))
+        except Exception as e:
+            logging.warning("Failed to parse Viewpoint metadata: '{}', '{}'".format(str(e), metadataStr))
+            return None
+        _metadataCache.add(metadataStr, metadata)
+    return metadata
+
+
+def clearCache():
+    """ Clear parsed metadata and values computed from viewpoints. """
+    _metadataCache.clear()
+    _nbBracketsCache.clear()
+
+
+def estimateNbBrackets(viewpoints):
+    """
+    Estimate the number of exposure brackets of CameraInit 'viewpoints', from the exposure settings of their images.
+    Images are sorted by path: a new bracket starts when the exposure of the first image of the current one comes back.
+
+    Args:
+        viewpoints: the viewpoints ListAttribute of a CameraInit node (or any iterable of viewpoints)
+
+    Returns:
+        int: the number of brackets, 1 if an image has no exposure settings, 0 if it can not be determined
+    """
+    # identify viewpoints by their content: strings are compared by reference when unchanged
+    key = tuple((viewpoint.path.value, viewpoint.metadata.value) for viewpoint in viewpoints)
+    nbBrackets = _nbBracketsCache.get(key)
+    if nbBrackets is None:
+        nbBrackets = _nbBracketsCache.add(key, _computeNbBrackets(key))
+    return nbBrackets
+
+
+def _computeNbBrackets(viewpoints):
+    inputs = []
+    for path, metadataStr in viewpoints:
+        metadata = parseMetadata(metadataStr)
+        if metadata is None:
+            # no metadata, we cannot found the number of brackets
+            return 0
+        if not metadata.hasExposure:
+            # If one image without shutter or fnumber, we cannot found the number of brackets.
+            # We assume that there is no multi-bracketing, so nothing to do.
+            return 1
+        inputs.append((path, metadata.exposure))
+    inputs.sort()
+
+    exposureGroups = []
+    exposures = []
+    for path, exp in inputs:
+        if exposures and exp != exposures[-1] and exp == exposures[0]:
+            exposureGroups.append(exposures)
+            exposures = [exp]
+        else:
+            exposures.append(exp)
+    exposureGroups.append(exposures)
+    if len(exposureGroups) == 1:
+        if len(set(exposureGroups[0])) == 1:
+            # Single exposure and multiple views
+            return 1
+        # Single view and multiple exposures
+        return len(exposureGroups[0])
+    bracketSizes = set(len(expGroup) for expGroup in exposureGroups)
+    if len(bracketSizes) == 1:
+        return bracketSizes.pop()
+    return 0
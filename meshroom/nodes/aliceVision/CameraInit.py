@@ -2,12 +2,16 @@ __version__ = "3.0"
 
 import os
 import json
+import math
 import psutil
 import shutil
 import tempfile
 import logging
+from collections import OrderedDict
+from multiprocessing.pool import ThreadPool
 
 from meshroom.core import desc
+from meshroom.core.imageIntrinsicsCache import ImageIntrinsicsCache, paramsKey
 
 
 Viewpoint = [
@@ -111,6 +115,31 @@ def readSfMData(sfmFile):
 
     return views, intrinsics
 
+def shardViews(views, nbShards):
+    """
+    Split 'views' in shards of contiguous views of the same folders, of about len(views) / 'nbShards' views.
+    Folders are kept in a single shard when they fit in it: images grouped by folder (see 'groupCameraFallback') are
+    processed together. Larger folders are split in contiguous parts.
+
+    Returns:
+        list of list: the views of each shard, in the order of 'views' within each folder
+    """
+    folders = OrderedDict()
+    for view in views:
+        folders.setdefault(os.path.dirname(os.path.abspath(view['path'])), []).append(view)
+    shardSize = max(1, int(math.ceil(len(views) / float(nbShards))))
+    shards = [[]]
+    for folderViews in folders.values():
+        # a folder that does not fit in the current shard starts a new one
+        if shards[-1] and len(shards[-1]) + len(folderViews) > shardSize:
+            shards.append([])
+        for view in folderViews:
+            if len(shards[-1]) >= shardSize:
+                shards.append([])
+            shards[-1].append(view)
+    return shards
+
+
 class CameraInit(desc.CommandLineNode):
     commandLine = 'aliceVision_cameraInit {allParams} --allowSingleView 1' # don't throw an error if there is only one image
 
@@ -244,12 +273,19 @@ The metadata needed are:
     def readSfMData(self, sfmFile):
         return readSfMData(sfmFile)
 
-    def buildIntrinsics(self, node, additionalViews=()):
+    def buildIntrinsics(self, node, additionalViews=(), cache=None, maxProcesses=None):
         """ Build intrinsics from node current views and optional additional views
 
+        Views that already have metadata are kept as is: only the other ones and the additional views are processed.
+        Their results are first looked up in the persistent per-image cache, aliceVision_cameraInit is only run on
+        the remaining images, split in shards processed in parallel.
+
         Args:
             node: the CameraInit node instance to build intrinsics for
             additionalViews: (optional) the new views (list of path to images) to add to the node's viewpoints
+            cache (ImageIntrinsicsCache): (optional) the per-image cache (defaults to the user cache folder)
+            maxProcesses (int): (optional) the maximum number of aliceVision_cameraInit processes run in parallel
+                                (defaults to the number of CPUs)
 
         Returns:
             The updated views and intrinsics as two separate lists
@@ -259,26 +295,121 @@ The metadata needed are:
             # make a copy of the node outside the graph
             # to change its cache folder without modifying the original node
             node = node.graph.copyNode(node)[0]
+        cache = cache or ImageIntrinsicsCache()
+
+        intrinsics = node.intrinsics.getPrimitiveValue(exportDefault=True)
+        views = node.viewpoints.getPrimitiveValue(exportDefault=False)
+        newViews = [{"path": path} for path in additionalViews]  # format additional views to match json format
+        pendingViews = [view for view in views if not view.get('metadata')] + newViews
+        if not pendingViews:
+            return views, intrinsics
+
+        def pathKey(path):
+            # the tool may not write the image paths as given
+            return os.path.normpath(os.path.abspath(path))
+
+        key = self.parametersKey(node)
+        results = {}  # normalized image path -> (view, intrinsic)
+        missingViews = []
+        for view in pendingViews:
+            cached = cache.get(view['path'], key)
+            if cached:
+                results[pathKey(view['path'])] = cached
+            else:
+                missingViews.append(view)
+        logging.debug("[CameraInit] {} images to process, {} found in cache.".format(
+            len(pendingViews), len(pendingViews) - len(missingViews)))
+
+        if missingViews:
+            for view, intrinsic in self.runCameraInit(node, missingViews, intrinsics, maxProcesses):
+                cache.add(view['path'], key, view, intrinsic)
+                results[pathKey(view['path'])] = (view, intrinsic)
+            cache.cleanupIfNeeded()
+
+        # merge results, keeping views order and existing intrinsics
+        intrinsicIds = set(intrinsic['intrinsicId'] for intrinsic in intrinsics)
+        updatedViews = []
+        for view in views + newViews:
+            if view.get('metadata'):
+                updatedViews.append(view)
+                continue
+            result = results.get(pathKey(view['path']))
+            if result is None:
+                logging.warning("[CameraInit] No view has been created for image '{}'.".format(view['path']))
+                continue
+            newView, intrinsic = result
+            # keep user-defined ids of existing views
+            newView = dict(newView, **{k: v for k, v in view.items() if k != 'path' and v != -1})
+            updatedViews.append(newView)
+            if intrinsic and intrinsic['intrinsicId'] not in intrinsicIds:
+                intrinsicIds.add(intrinsic['intrinsicId'])
+                intrinsics.append(intrinsic)
+        return updatedViews, intrinsics
+
+    def parametersKey(self, node):
+        """
+        Get the key identifying the parameters of 'node' that the views and intrinsics of an image depend on,
+        including the existing intrinsics given to the tool, that views can be assigned to.
+        """
+        params = {attr.name: attr.getPrimitiveValue(exportDefault=True) for attr in node.attributes
+                  if attr.isInput and attr.name not in ('viewpoints', 'verboseLevel')}
+        # the sensor database can be modified in place
+        sensorDatabase = node.sensorDatabase.value
+        params['sensorDatabaseMTime'] = os.path.getmtime(sensorDatabase) if os.path.isfile(sensorDatabase) else None
+        return paramsKey(params)
 
-        tmpCache = tempfile.mkdtemp()
-        node.updateInternals(tmpCache)
+    def runCameraInit(self, node, views, intrinsics, maxProcesses=None, minShardSize=50):
+        """ Run aliceVision_cameraInit on 'views', split in shards processed in parallel.
+
+        Args:
+            node: the CameraInit node instance (outside of any graph)
+            views: the views to process
+            intrinsics: the existing intrinsics that views can be assigned to
+            maxProcesses (int): the maximum number of processes run in parallel (defaults to the number of CPUs)
+            minShardSize (int): the minimum number of views per process
 
+        Returns:
+            list of tuple: the (view, intrinsic) of each processed image, intrinsic being None if the view has none
+        """
+        maxProcesses = maxProcesses or psutil.cpu_count() or 1
+        shards = shardViews(views, max(1, min(maxProcesses, len(views) // minShardSize)))
+        nbShards = len(shards)
+
+        tmpCache = tempfile.mkdtemp()
         try:
-            os.makedirs(os.path.join(tmpCache, node.internalFolder))
-            self.createViewpointsFile(node, additionalViews)
-            cmd = self.buildCommandLine(node.chunks[0])
-            logging.debug(' - commandLine: {}'.format(cmd))
-            proc = psutil.Popen(cmd, stdout=None, stderr=None, shell=True)
-            stdout, stderr = proc.communicate()
-            # proc.wait()
-            if proc.returncode != 0:
-                raise RuntimeError('CameraInit failed with error code {}.\nCommand was: "{}".\n'.format(
-                    proc.returncode, cmd)
-                )
-
-            # Reload result of aliceVision_cameraInit
-            cameraInitSfM = node.output.value
-            return readSfMData(cameraInitSfM)
+            commands = []
+            for i, shardViews in enumerate(shards):
+                # each shard is computed in its own cache folder
+                node.updateInternals(os.path.join(tmpCache, str(i)))
+                os.makedirs(node.internalFolder)
+                node.viewpointsFile = (node.nodeDesc.internalFolder + '/viewpoints.sfm').format(**node._cmdVars)
+                self.writeViewpointsFile(node.viewpointsFile, shardViews, intrinsics)
+                commands.append((self.buildCommandLine(node.chunks[0]), node.output.value))
+
+            def runShard(command):
+                cmd, output = command
+                logging.debug(' - commandLine: {}'.format(cmd))
+                proc = psutil.Popen(cmd, stdout=None, stderr=None, shell=True)
+                proc.communicate()
+                if proc.returncode != 0:
+                    raise RuntimeError('CameraInit failed with error code {}.\nCommand was: "{}".\n'.format(
+                        proc.returncode, cmd)
+                    )
+                # Reload result of aliceVision_cameraInit
+                return readSfMData(output)
+
+            pool = ThreadPool(min(nbShards, maxProcesses))
+            try:
+                shardResults = pool.map(runShard, commands)
+            finally:
+                pool.close()
+
+            results = []
+            for shardViews, shardIntrinsics in shardResults:
+                intrinsicsById = {intrinsic['intrinsicId']: intrinsic for intrinsic in shardIntrinsics}
+                for view in shardViews:
+                    results.append((view, intrinsicsById.get(view.get('intrinsicId'))))
+            return results
 
         except Exception as e:
             logging.debug("[CameraInit] Error while building intrinsics: {}".format(str(e)))
@@ -295,28 +426,35 @@ The metadata needed are:
             for path in additionalViews:  # format additional views to match json format
                 newViews.append({"path": path})
             intrinsics = node.intrinsics.getPrimitiveValue(exportDefault=True)
-            for intrinsic in intrinsics:
-                intrinsic['principalPoint'] = [intrinsic['principalPoint']['x'], intrinsic['principalPoint']['y']]
             views = node.viewpoints.getPrimitiveValue(exportDefault=False)
-
-            # convert the metadata string into a map
-            for view in views:
-                if 'metadata' in view:
-                    view['metadata'] = json.loads(view['metadata'])
-
-            sfmData = {
-                "version": [1, 0, 0],
-                "views": views + newViews,
-                "intrinsics": intrinsics,
-                "featureFolder": "",
-                "matchingFolder": "",
-            }
             node.viewpointsFile = (node.nodeDesc.internalFolder + '/viewpoints.sfm').format(**node._cmdVars)
-            with open(node.viewpointsFile, 'w') as f:
-                json.dump(sfmData, f, indent=4)
-
-    def buildCommandLine(self, chunk):
-        cmd = desc.CommandLineNode.buildCommandLine(self, chunk)
+            self.writeViewpointsFile(node.viewpointsFile, views + newViews, intrinsics)
+
+    def writeViewpointsFile(self, filepath, views, intrinsics):
+        """ Write 'views' and 'intrinsics' (as exported by the node attributes) to the .sfm file 'filepath'. """
+        intrinsics = [dict(intrinsic) for intrinsic in intrinsics]
+        for intrinsic in intrinsics:
+            intrinsic['principalPoint'] = [intrinsic['principalPoint']['x'], intrinsic['principalPoint']['y']]
+        views = [dict(view) for view in views]
+        # convert the metadata string into a map
+        for view in views:
+            if view.get('metadata'):
+                view['metadata'] = json.loads(view['metadata'])
+            else:
+                view.pop('metadata', None)
+
+        sfmData = {
+            "version": [1, 0, 0],
+            "views": views,
+            "intrinsics": intrinsics,
+            "featureFolder": "",
+            "matchingFolder": "",
+        }
+        with open(filepath, 'w') as f:
+            json.dump(sfmData, f, indent=4)
+
+    def buildCommandLine(self, chunk, args=None):
+        cmd = desc.CommandLineNode.buildCommandLine(self, chunk, args)
         if chunk.node.viewpointsFile:
             cmd += ' --input "{}"'.format(chunk.node.viewpointsFile)
         return cmd
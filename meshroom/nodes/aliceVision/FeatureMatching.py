@@ -1,12 +1,17 @@
 __version__ = "2.0"
 
+import os
+import shutil
+
 from meshroom.core import desc
+from meshroom.core.matchingPairs import readPairs, writePairs, pairCosts, partitionPairs
 
 
 class FeatureMatching(desc.CommandLineNode):
     commandLine = 'aliceVision_featureMatching {allParams}'
-    size = desc.DynamicNodeSize('input')
+    size = desc.SfMViewsNodeSize('input')
     parallelization = desc.Parallelization(blockSize=20)
+    # only used without image pairs list: chunks are given parts of the pairs list otherwise (see processChunk)
     commandLineRange = '--rangeStart {rangeStart} --rangeSize {rangeBlockSize}'
 
     documentation = '''
@@ -208,3 +213,37 @@ then it checks the number of features that validates this model and iterate thro
             uid=[],
         ),
     ]
+
+    def processChunk(self, chunk):
+        node = chunk.node
+        pairsList = node.imagePairsList.value
+        if len(node.chunks) < 2 or not os.path.isfile(pairsList):
+            super(FeatureMatching, self).processChunk(chunk)
+            return
+
+        # split the pairs in parts of balanced matching cost (same split computed by all chunks)
+        pairs = readPairs(pairsList)
+        costs = pairCosts(pairs, [folder.value for folder in node.featuresFolders.value], node.describerTypes.value)
+        chunkPairs = partitionPairs(pairs, costs, len(node.chunks))[chunk.index]
+
+        chunkFolder = self.chunkFolder(node, chunk.index)
+        if os.path.isdir(chunkFolder):
+            shutil.rmtree(chunkFolder)
+        os.makedirs(chunkFolder)
+        if not chunkPairs:
+            return
+        pairsFile = os.path.join(self.chunksFolder(node), '{}.pairs.txt'.format(chunk.index))
+        writePairs(chunkPairs, pairsFile)
+        # the pairs of the chunk replace the images range
+        super(FeatureMatching, self).processChunk(chunk, {
+            'rangeStart': None,
+            'rangeSize': None,
+            'imagePairsList': '"{}"'.format(pairsFile),
+            'output': '"{}"'.format(chunkFolder),
+        })
+        # matches files are prefixed by the chunk index, as the ones of ranged chunks
+        for f in os.listdir(chunkFolder):
+            destination = os.path.join(node.output.value, '{}.{}'.format(chunk.index, f))
+            if os.path.exists(destination):
+                os.remove(destination)
+            os.rename(os.path.join(chunkFolder, f), destination)
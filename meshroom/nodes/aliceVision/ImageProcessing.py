@@ -1,8 +1,12 @@
 __version__ = "3.0"
 
 from meshroom.core import desc
+from meshroom.core.fileUtils import writeFileAtomic
 
+import json
 import os.path
+import re
+import shutil
 
 def outputImagesValueFunct(attr):
     basename = os.path.basename(attr.node.input.value)
@@ -28,11 +32,74 @@ def outputImagesValueFunct(attr):
     return desc.Node.internalFolder + '*' + (outputExt or '.*')
 
 
+def filterToRegex(pattern):
+    """ Convert an input image filter ('#': a digit, '@': one or more digits, '?': one character, '*': any) to a regex. """
+    conversions = {'#': '[0-9]', '@': '[0-9]+', '?': '.', '*': '.*'}
+    return ''.join(conversions.get(c, re.escape(c)) for c in pattern) + '$'
+
+
+def resolveInputImages(inputPath):
+    """
+    Get the sorted list of images processed for the non-SfMData 'inputPath': the images of a folder,
+    the images matching a filter (see filterToRegex) or a single image.
+    """
+    # not imported at module level: nodes are loaded by meshroom.core, which meshroom.multiview depends on
+    from meshroom.multiview import imageExtensions, hasExtension
+    if not inputPath:
+        return []
+    if os.path.isdir(inputPath):
+        folder, regex = inputPath, None
+    elif os.path.isfile(inputPath):
+        return [inputPath]
+    else:
+        folder, regex = os.path.dirname(inputPath), re.compile(filterToRegex(os.path.basename(inputPath)))
+        if not os.path.isdir(folder):
+            return []
+    return sorted(os.path.join(folder, f) for f in os.listdir(folder)
+                  if hasExtension(f, imageExtensions) and (regex is None or regex.match(f))
+                  and os.path.isfile(os.path.join(folder, f)))
+
+
+def splitRange(items, index, nbChunks):
+    """
+    Get the contiguous part 'index' of 'items' split in 'nbChunks' parts of balanced sizes.
+    Parts are computed from the actual items: the split stays complete if their number differs from the node size.
+    """
+    return items[index * len(items) // nbChunks:(index + 1) * len(items) // nbChunks]
+
+
+def _linkFile(source, destination):
+    try:
+        os.symlink(os.path.abspath(source), destination)
+    except (AttributeError, OSError):
+        # no symbolic links (e.g. Windows without privileges)
+        shutil.copy2(source, destination)
+
+
+def _writeJson(data, path):
+    writeFileAtomic(path, lambda f: json.dump(data, f, indent=4))
+
+
+class ImageProcessingSize(desc.SfMViewsNodeSize):
+    """
+    Number of views of the SfMData input or number of input images.
+    An Alembic SfMData can not be split by Meshroom: its size is 1.
+    """
+    def computeSize(self, node):
+        param = node.attribute(self._param)
+        inputExt = os.path.splitext(param.value)[1].lower()
+        if inputExt == '.abc':
+            return 1
+        if param.isLink or inputExt == '.sfm':
+            return super(ImageProcessingSize, self).computeSize(node)
+        return max(1, len(resolveInputImages(param.value)))
+
+
 class ImageProcessing(desc.CommandLineNode):
     commandLine = 'aliceVision_utils_imageProcessing {allParams}'
-    size = desc.DynamicNodeSize('input')
-    # parallelization = desc.Parallelization(blockSize=40)
-    # commandLineRange = '--rangeStart {rangeStart} --rangeSize {rangeBlockSize}'
+    size = ImageProcessingSize('input')
+    # the tool has no range option: each chunk is run on its own part of the input (see processChunk)
+    parallelization = desc.Parallelization(blockSize=40)
 
     documentation = '''
 Convert or apply filtering to the input images.
@@ -337,3 +404,85 @@ Convert or apply filtering to the input images.
             uid=[],
         ),
     ]
+
+    @staticmethod
+    def _isSplit(node):
+        return len(node.chunks) > 1 and os.path.splitext(node.input.value)[1].lower() != '.abc'
+
+    def processChunk(self, chunk):
+        node = chunk.node
+        if not self._isSplit(node):
+            if chunk.index == 0:
+                super(ImageProcessing, self).processChunk(chunk)
+            # else: an Alembic input is processed at once by the first chunk
+            return
+
+        self.chunkStarted(chunk)
+        chunkFolder = self.chunkFolder(node, chunk.index)
+        if os.path.isdir(chunkFolder):
+            shutil.rmtree(chunkFolder)
+        inputPath = node.input.value
+        if os.path.splitext(inputPath)[1].lower() == '.sfm':
+            # SfMData restricted to the views of the chunk, processed into the chunk folder
+            with open(inputPath) as f:
+                sfmData = json.load(f)
+            views = splitRange(sfmData.get('views', []), chunk.index, len(node.chunks))
+            sfmData['views'] = views
+            inputFolder = os.path.join(chunkFolder, 'input')
+            outputFolder = os.path.join(chunkFolder, 'output')
+            os.makedirs(inputFolder)
+            os.makedirs(outputFolder)
+            chunkInput = os.path.join(inputFolder, os.path.basename(inputPath))
+            _writeJson(sfmData, chunkInput)
+            if views:
+                args = {'input': '"{}"'.format(chunkInput), 'output': '"{}"'.format(outputFolder)}
+                super(ImageProcessing, self).processChunk(chunk, args)
+                # images are moved to the node folder, the SfMData part is merged by mergeChunks
+                partFile = os.path.basename(inputPath)
+                for f in os.listdir(outputFolder):
+                    if f != partFile:
+                        os.rename(os.path.join(outputFolder, f), os.path.join(node.internalFolder, f))
+            else:
+                shutil.copy2(chunkInput, outputFolder)
+        else:
+            # folder of links to the images of the chunk, processed into the node folder:
+            # links are named after their image, the outputs are the same as when processed at once
+            images = splitRange(resolveInputImages(inputPath), chunk.index, len(node.chunks))
+            imagesFolder = os.path.join(chunkFolder, 'images')
+            os.makedirs(imagesFolder)
+            for image in images:
+                _linkFile(image, os.path.join(imagesFolder, os.path.basename(image)))
+            if images:
+                super(ImageProcessing, self).processChunk(chunk, {'input': '"{}"'.format(imagesFolder)})
+        self.chunkDone(chunk)
+
+    def mergeChunks(self, node):
+        inputPath = node.input.value
+        if os.path.splitext(inputPath)[1].lower() != '.sfm':
+            # images are written to the node folder by each chunk
+            return
+        merged = None
+        for index in range(len(node.chunks)):
+            outputFolder = os.path.normpath(os.path.join(self.chunkFolder(node, index), 'output'))
+            with open(os.path.join(outputFolder, os.path.basename(inputPath))) as f:
+                sfmData = json.load(f)
+            # views of the chunk images have been moved to the node folder
+            for view in sfmData.get('views', []):
+                if os.path.normpath(os.path.dirname(view['path'])) == outputFolder:
+                    view['path'] = os.path.join(node.internalFolder, os.path.basename(view['path']))
+            if merged is None:
+                merged = sfmData
+                continue
+            # chunks are contiguous parts of the input views: the input order is kept
+            merged['views'].extend(sfmData.get('views', []))
+            # intrinsics and poses may be updated by the processing of each chunk (e.g. undistortion)
+            for key, idKey in (('intrinsics', 'intrinsicId'), ('poses', 'poseId')):
+                if key not in sfmData:
+                    continue
+                items = merged.setdefault(key, [])
+                ids = set(item[idKey] for item in items)
+                for item in sfmData[key]:
+                    if item[idKey] not in ids:
+                        ids.add(item[idKey])
+                        items.append(item)
+        _writeJson(merged, node.outSfMData.value)
@@ -1,11 +1,36 @@
-__version__ = "2.0"
+__version__ = "3.0"
 
 import os
+import shutil
 from meshroom.core import desc
 
+# parameters given per media
+mediaParams = ('mediaPaths', 'brands', 'models', 'mmFocals', 'pxFocals', 'frameOffsets')
+
+
+def isSynchronized(node):
+    """
+    Whether the media of 'node' have to be processed at once.
+    When the media are the synchronized cameras of a rig (the default) and keyframes are selected from the image
+    content (sharpness or sparse distance, enabled by default), they are selected for all the cameras at once.
+    Otherwise, each media is processed independently.
+    """
+    return node.synchronizedRig.value and (node.useSparseDistanceSelection.value or node.useSharpnessSelection.value)
+
+
+class KeyframeSelectionSize(desc.DynamicNodeSize):
+    """ One chunk per media, a single chunk when the media are synchronized (with the default settings). """
+    def computeSize(self, node):
+        if isSynchronized(node):
+            return 1
+        return super(KeyframeSelectionSize, self).computeSize(node)
+
 
 class KeyframeSelection(desc.CommandLineNode):
     commandLine = 'aliceVision_utils_keyframeSelection {allParams}'
+    size = KeyframeSelectionSize('mediaPaths')
+    # one media per chunk (see processChunk)
+    parallelization = desc.Parallelization(blockSize=1)
 
     documentation = '''
 Allows to extract keyframes from a video and insert metadata.
@@ -104,6 +129,15 @@ You can extract frames at regular interval by configuring only the min/maxFrameS
             value=os.environ.get('ALICEVISION_VOCTREE', ''),
             uid=[0],
         ),
+        desc.BoolParam(
+            name='synchronizedRig',
+            label='Synchronized Rig',
+            description='The media are the synchronized cameras of a rig: keyframes are selected at the same time for all the cameras.\n'
+                        'Otherwise, keyframes are selected for each media independently, and the media are processed in parallel.',
+            value=True,
+            uid=[0],
+            group='',  # not a command line argument, the media are split by Meshroom
+        ),
         desc.BoolParam(
             name='useSparseDistanceSelection',
             label='Use Sparse Distance Selection',
@@ -188,3 +222,44 @@ You can extract frames at regular interval by configuring only the min/maxFrameS
         ),
     ]
 
+    @staticmethod
+    def _isSplit(node):
+        """ Whether the media of 'node' are processed independently (see isSynchronized). """
+        return len(node.chunks) > 1
+
+    def mediaArguments(self, node, mediaIndex):
+        """ Get the arguments computing the media 'mediaIndex' of 'node' alone (see processChunk). """
+        args = {'outputFolder': '"{}"'.format(self.chunkFolder(node, mediaIndex))}
+        # only pass the parameters of the media
+        for name in mediaParams:
+            attr = node.attribute(name)
+            args[name] = attr.at(mediaIndex).getValueStr() if mediaIndex < len(attr) else None
+        return args
+
+    def processChunk(self, chunk):
+        node = chunk.node
+        if not self._isSplit(node):
+            super(KeyframeSelection, self).processChunk(chunk)
+            return
+
+        self.chunkStarted(chunk)
+        chunkFolder = self.chunkFolder(node, chunk.index)
+        if os.path.isdir(chunkFolder):
+            shutil.rmtree(chunkFolder)
+        os.makedirs(chunkFolder)
+        super(KeyframeSelection, self).processChunk(chunk, self.mediaArguments(node, chunk.index))
+        self.chunkDone(chunk)
+
+    def mergeChunks(self, node):
+        if not self._isSplit(node):
+            return
+        # same layout as the frames of a rig extracted at once: outputFolder/rig/<mediaIndex>/<frame>
+        for index in range(len(node.chunks)):
+            chunkFolder = self.chunkFolder(node, index)
+            if not os.path.isdir(chunkFolder):
+                # already merged
+                continue
+            mediaFolder = os.path.join(node.outputFolder.value, 'rig', str(index))
+            if os.path.isdir(mediaFolder):
+                shutil.rmtree(mediaFolder)
+            shutil.move(chunkFolder, mediaFolder)
@@ -1,26 +1,7 @@
 __version__ = "3.0"
 
-import json
-
 from meshroom.core import desc
-
-def findMetadata(d, keys, defaultValue):
-    v = None
-    for key in keys:
-        v = d.get(key, None)
-        k = key.lower()
-        if v is not None:
-            return v
-        for dk, dv in d.items():
-            dkm = dk.lower().replace(" ", "")
-            if dkm == key.lower():
-                return dv
-            dkm = dkm.split(":")[-1]
-            dkm = dkm.split("/")[-1]
-            if dkm == k:
-                return dv
-    return defaultValue
-
+from meshroom.core.viewpointMetadata import estimateNbBrackets
 
 
 class LdrToHdrCalibration(desc.CommandLineNode):
@@ -177,51 +158,6 @@ class LdrToHdrCalibration(desc.CommandLineNode):
             node.nbBrackets.value = 0
             return
 
-        # logging.info("[LDRToHDR] Update start: nb viewpoints:" + str(len(viewpoints)))
-        inputs = []
-        for viewpoint in viewpoints:
-            jsonMetadata = viewpoint.metadata.value
-            if not jsonMetadata:
-                # no metadata, we cannot found the number of brackets
-                node.nbBrackets.value = 0
-                return
-            d = json.loads(jsonMetadata)
-            fnumber = findMetadata(d, ["FNumber", "Exif:ApertureValue", "ApertureValue", "Aperture"], "")
-            shutterSpeed = findMetadata(d, ["Exif:ShutterSpeedValue", "ShutterSpeedValue", "ShutterSpeed"], "")
-            iso = findMetadata(d, ["Exif:ISOSpeedRatings", "ISOSpeedRatings", "ISO"], "")
-            if not fnumber and not shutterSpeed:
-                # If one image without shutter or fnumber, we cannot found the number of brackets.
-                # We assume that there is no multi-bracketing, so nothing to do.
-                node.nbBrackets.value = 1
-                return
-            inputs.append((viewpoint.path.value, (fnumber, shutterSpeed, iso)))
-        inputs.sort()
-
-        exposureGroups = []
-        exposures = []
-        for path, exp in inputs:
-            if exposures and exp != exposures[-1] and exp == exposures[0]:
-                exposureGroups.append(exposures)
-                exposures = [exp]
-            else:
-                exposures.append(exp)
-        exposureGroups.append(exposures)
-        exposures = None
-        bracketSizes = set()
-        if len(exposureGroups) == 1:
-            if len(set(exposureGroups[0])) == 1:
-                # Single exposure and multiple views
-                node.nbBrackets.value = 1
-            else:
-                # Single view and multiple exposures
-                node.nbBrackets.value = len(exposureGroups[0])
-        else:
-            for expGroup in exposureGroups:
-                bracketSizes.add(len(expGroup))
-            if len(bracketSizes) == 1:
-                node.nbBrackets.value = bracketSizes.pop()
-                # logging.info("[LDRToHDR] nb bracket size:" + str(node.nbBrackets.value))
-            else:
-                node.nbBrackets.value = 0
+        node.nbBrackets.value = estimateNbBrackets(viewpoints)
         # logging.info("[LDRToHDR] Update end")
 
@@ -1,10 +1,38 @@
-__version__ = "6.0"
+__version__ = "7.0"
+
+import json
+import os
+import shutil
 
 from meshroom.core import desc
+from meshroom.core.fileUtils import writeFileAtomic
+from meshroom.core.meshPartition import Box, Partition, estimateBoundingBox, mergeMeshes, mergeStructures
+
+
+def canPartition(node):
+    """ Whether the meshing space of 'node' can be partitioned: its box is custom or estimated from an SfMData JSON file. """
+    if node.useBoundingBox.value:
+        return True
+    return node.estimateSpaceFromSfM.value and os.path.splitext(node.input.value)[1].lower() == '.sfm'
+
+
+def isPartitioned(node):
+    return canPartition(node) and node.partitionCells.value > 1
+
+
+class MeshingSize(desc.DynamicNodeSize):
+    """ One chunk per partition cell, a single chunk while the meshing space can not be partitioned. """
+    def computeSize(self, node):
+        if not canPartition(node):
+            return 1
+        return super(MeshingSize, self).computeSize(node)
 
 
 class Meshing(desc.CommandLineNode):
     commandLine = 'aliceVision_meshing {allParams}'
+    size = MeshingSize('partitionCells')
+    # one cell of the partitioned space per chunk (see processChunk)
+    parallelization = desc.Parallelization(blockSize=1)
 
     cpu = desc.Level.INTENSIVE
     ram = desc.Level.INTENSIVE
@@ -130,6 +158,34 @@ A Graph Cut Max-Flow is applied to optimally cut the volume. This cut represents
             joinChar=",",
             enabled=lambda node: node.useBoundingBox.value,
         ),
+        desc.IntParam(
+            name='partitionCells',
+            label='Partition Cells (Experimental)',
+            description='Experimental: split the bounding box into this number of cells, meshed in parallel and merged afterwards (1: mesh the whole space at once).\n'
+                        'The cells are not stitched: vertices shared by neighbour cells are welded, but the cell meshes leave small seams '
+                        '(cracks or overlapping triangles) along the cell borders where their triangulations differ. '
+                        'Do not keep the largest mesh only when filtering a partitioned mesh.\n'
+                        'Without Custom Bounding Box, the box is estimated from the landmarks of the input SfMData with the Estimate Space From SfM settings, '
+                        'which requires a JSON file (.sfm): the space is not partitioned otherwise.\n'
+                        'The dense point cloud is then saved as an SfMData JSON file.',
+            value=1,
+            range=(1, 64, 1),
+            uid=[0],
+            advanced=True,
+            group='',  # not part of allParams, the space is split by Meshroom
+            enabled=canPartition,
+        ),
+        desc.FloatParam(
+            name='partitionOverlap',
+            label='Partition Overlap',
+            description='Size of the overlap between neighbour cells (fraction of the cell size).',
+            value=0.1,
+            range=(0.0, 0.5, 0.01),
+            uid=[0],
+            advanced=True,
+            group='',
+            enabled=isPartitioned,
+        ),
         desc.BoolParam(
             name='estimateSpaceFromSfM',
             label='Estimate Space From SfM',
@@ -348,7 +404,70 @@ A Graph Cut Max-Flow is applied to optimally cut the volume. This cut represents
             name="output",
             label="Dense SfMData",
             description="Output dense point cloud with visibilities (SfMData file format).",
-            value="{cache}/{nodeType}/{uid0}/densePointCloud.abc",
+            value=lambda attr: "{cache}/{nodeType}/{uid0}/densePointCloud." + ("sfm" if isPartitioned(attr.node) else "abc"),
             uid=[],
         ),
     ]
+
+    @staticmethod
+    def partition(node):
+        """ Get the Partition of the meshing space of 'node'. """
+        if node.useBoundingBox.value:
+            box = Box(*[[node.attribute('boundingBox.{}.{}'.format(name, axis)).value for axis in 'xyz']
+                        for name in ('bboxTranslation', 'bboxRotation', 'bboxScale')])
+        else:
+            box = Meshing.estimatedBoundingBox(node)
+            if box is None:
+                raise RuntimeError('Partitioned meshing: the bounding box can not be estimated from "{}", '
+                                   'a Custom Bounding Box is needed.'.format(node.input.value))
+        return Partition(box, node.partitionCells.value, node.partitionOverlap.value)
+
+    @staticmethod
+    def estimatedBoundingBox(node):
+        """
+        Get the bounding box of 'node' estimated from its input SfMData, None if it can not be estimated.
+        The box is estimated once and stored in the chunks folder, shared by the chunks and the merge.
+        """
+        if not canPartition(node):
+            return None
+        inputStat = os.stat(node.input.value)
+        key = [node.input.value, inputStat.st_size, inputStat.st_mtime]
+        boxFile = os.path.join(Meshing.chunksFolder(node), 'boundingBox.json')
+        try:
+            with open(boxFile) as f:
+                stored = json.load(f)
+            if stored['input'] == key:
+                return Box(*stored['box']) if stored['box'] else None
+        except (IOError, OSError, ValueError, KeyError):
+            pass
+        box = estimateBoundingBox(node.input.value, node.estimateSpaceMinObservations.value,
+                                  node.estimateSpaceMinObservationAngle.value)
+        if not os.path.isdir(os.path.dirname(boxFile)):
+            os.makedirs(os.path.dirname(boxFile))
+        writeFileAtomic(boxFile, lambda f: json.dump({'input': key, 'box': box.toList() if box else None}, f))
+        return box
+
+    def processChunk(self, chunk):
+        node = chunk.node
+        if len(node.chunks) < 2:
+            super(Meshing, self).processChunk(chunk)
+            return
+
+        self.chunkStarted(chunk)
+        cellBox = self.partition(node).cellBox(chunk.index)
+        chunkFolder = self.chunkFolder(node, chunk.index)
+        if os.path.isdir(chunkFolder):
+            shutil.rmtree(chunkFolder)
+        os.makedirs(chunkFolder)
+        super(Meshing, self).processChunk(chunk, {
+            'boundingBox': ','.join(str(v) for values in cellBox.toList() for v in values),
+            'outputMesh': '"{}"'.format(os.path.join(chunkFolder, 'mesh.obj')),
+            'output': '"{}"'.format(os.path.join(chunkFolder, 'densePointCloud.sfm')),
+        })
+        self.chunkDone(chunk)
+
+    def mergeChunks(self, node):
+        partition = self.partition(node)
+        folders = [self.chunkFolder(node, index) for index in range(len(node.chunks))]
+        mergeMeshes([os.path.join(folder, 'mesh.obj') for folder in folders], partition, node.outputMesh.value)
+        mergeStructures([os.path.join(folder, 'densePointCloud.sfm') for folder in folders], partition, node.output.value)
@@ -9,6 +9,8 @@ from meshroom.core import desc
 class PanoramaCompositing(desc.CommandLineNode):
     commandLine = 'aliceVision_panoramaCompositing {allParams}'
     size = desc.DynamicNodeSize('input')
+    # Not parallelized: the whole panorama is composited by one process, the tool has no option to
+    # restrict it to a band or a tile of the output. Splitting the output requires this support in the tool.
 
     cpu = desc.Level.INTENSIVE
     ram = desc.Level.INTENSIVE
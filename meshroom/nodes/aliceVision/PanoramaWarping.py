@@ -8,7 +8,7 @@ from meshroom.core import desc
 
 class PanoramaWarping(desc.CommandLineNode):
     commandLine = 'aliceVision_panoramaWarping {allParams}'
-    size = desc.DynamicNodeSize('input')
+    size = desc.SfMViewsNodeSize('input')
 
     parallelization = desc.Parallelization(blockSize=5)
     commandLineRange = '--rangeStart {rangeStart} --rangeSize {rangeBlockSize}'
@@ -5,6 +5,8 @@ from meshroom.core import desc
 
 class Texturing(desc.CommandLineNode):
     commandLine = 'aliceVision_texturing {allParams}'
+    # Not parallelized: the tool unwraps the mesh and computes all the texture atlases (UDIM tiles) in one process,
+    # it has no option to compute a single atlas from an already unwrapped mesh.
     cpu = desc.Level.INTENSIVE
     ram = desc.Level.INTENSIVE
 
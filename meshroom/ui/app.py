@@ -15,6 +15,8 @@ from meshroom.ui import components
 from meshroom.ui.components.clipboard import ClipboardHelper
 from meshroom.ui.components.filepath import FilepathHelper
 from meshroom.ui.components.scene3D import Scene3DHelper, Transformations3DHelper
+from meshroom.ui.components.thumbnail import ThumbnailHelper
+from meshroom.ui.components.meshLod import MeshLodHelper
 from meshroom.ui.palette import PaletteManager
 from meshroom.ui.reconstruction import Reconstruction
 from meshroom.ui.utils import QmlInstantEngine
@@ -134,6 +136,17 @@ class MeshroomApp(QApplication):
         self.engine.rootContext().setContextProperty("Transformations3DHelper", Transformations3DHelper(parent=self))
         self.engine.rootContext().setContextProperty("Clipboard", ClipboardHelper(parent=self))
 
+        # image thumbnails, served by an image provider
+        thumbnails = ThumbnailHelper(parent=self)
+        self.engine.addImageProvider(ThumbnailHelper.providerId, thumbnails.imageProvider())
+        self.engine.rootContext().setContextProperty("Thumbnails", thumbnails)
+        self.aboutToQuit.connect(thumbnails.close)
+
+        # levels of detail of large 3D media
+        meshLodHelper = MeshLodHelper(parent=self)
+        self.engine.rootContext().setContextProperty("MeshLod", meshLodHelper)
+        self.aboutToQuit.connect(meshLodHelper.close)
+
         # additional context properties
         self.engine.rootContext().setContextProperty("_PaletteManager", PaletteManager(self.engine, parent=self))
         self.engine.rootContext().setContextProperty("MeshroomApp", self)
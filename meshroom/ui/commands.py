@@ -316,6 +316,26 @@ class MoveNodeCommand(GraphCommand):
         self.graph.node(self.nodeName).position = self.oldPosition
 
 
+class MoveNodesCommand(GraphCommand):
+    """ Move several nodes to given positions at once. """
+    def __init__(self, graph, positions, title, parent=None):
+        super(MoveNodesCommand, self).__init__(graph, parent)
+        self.newPositions = {node.name: position for node, position in positions.items()}
+        self.oldPositions = {node.name: node.position for node in positions}
+        self.setText(title)
+
+    def redoImpl(self):
+        self._setPositions(self.newPositions)
+        return True
+
+    def undoImpl(self):
+        self._setPositions(self.oldPositions)
+
+    def _setPositions(self, positions):
+        for nodeName, position in positions.items():
+            self.graph.node(nodeName).position = position
+
+
 class UpgradeNodeCommand(GraphCommand):
     """
     Perform node upgrade on a CompatibilityNode.
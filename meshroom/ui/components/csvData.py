@@ -1,22 +1,32 @@
 from meshroom.common.qt import QObjectListModel
+from meshroom.core.csvTable import readColumns, downsample
 
-from PySide2.QtCore import QObject, Slot, Signal, Property
+from PySide2.QtCore import QObject, QPointF, Slot, Signal, Property
 from PySide2.QtCharts import QtCharts
 
-import csv
+from threading import Thread
 import os
 import logging
 
 
 class CsvData(QObject):
-    """Store data from a CSV file."""
+    """
+    Store data from a CSV file.
+    The file is read in a separate thread: 'ready' becomes True once its columns are available.
+    The points displaying the columns as chart series are downsampled to 'maxPoints' in the same thread.
+    """
     def __init__(self, parent=None):
         """Initialize the object without any parameter."""
         super(CsvData, self).__init__(parent=parent)
         self._filepath = ""
         self._data = QObjectListModel(parent=self)  # List of CsvColumn
         self._ready = False
+        self._maxPoints = 0
+        # identifies the current read: results of previous ones are dropped
+        self._readId = 0
         self.filepathChanged.connect(self.updateData)
+        self.maxPointsChanged.connect(self.updateData)
+        self._columnsRead.connect(self._onColumnsRead)
 
     @Slot(int, result=QObject)
     def getColumn(self, index):
@@ -41,6 +51,13 @@ class CsvData(QObject):
         self._filepath = filepath
         self.filepathChanged.emit()
 
+    def setMaxPoints(self, maxPoints):
+        if self._maxPoints == maxPoints:
+            return
+        self.setReady(False)
+        self._maxPoints = maxPoints
+        self.maxPointsChanged.emit()
+
     def setReady(self, ready):
         if self._ready == ready:
             return
@@ -51,75 +68,89 @@ class CsvData(QObject):
     def updateData(self):
         self.setReady(False)
         self._data.clear()
-        newColumns = self.read()
-        if newColumns:
-            self._data.setObjectList(newColumns)
-            self.setReady(True)
-
-    def read(self):
-        """Read the CSV file and return a list containing CsvColumn objects."""
+        self._readId += 1
         if not self._filepath or not self._filepath.lower().endswith(".csv") or not os.path.isfile(self._filepath):
-            return []
+            return
+        thread = Thread(target=self.read, args=(self._readId, self._filepath, self._maxPoints))
+        thread.daemon = True
+        thread.start()
 
-        dataList = []
+    def read(self, readId, filepath, maxPoints):
+        """Read the CSV file 'filepath' and downsample its columns to 'maxPoints' points (called in a separate thread)."""
         try:
-            csvRows = []
-            with open(self._filepath, "r") as fp:
-                reader = csv.reader(fp)
-                for row in reader:
-                    csvRows.append(row)
-            # Create the objects in dataList
-            # with the first line elements as objects' title
-            for elt in csvRows[0]:
-                dataList.append(CsvColumn(elt)) # , parent=self._data
-            # Populate the content attribute
-            for elt in csvRows[1:]:
-                for idx, value in enumerate(elt):
-                    dataList[idx].appendValue(value)
+            result = readColumns(filepath, shouldStop=lambda: readId != self._readId)
+            if result is not None:
+                titles, columns = result
+                result = titles, columns, [downsample(values, maxPoints) for values in columns]
         except Exception as e:
-            logging.error("CsvData: Failed to load file: {}\n{}".format(self._filepath, str(e)))
-
-        return dataList
+            logging.error("CsvData: Failed to load file: {}\n{}".format(filepath, str(e)))
+            result = None
+        if result is not None:
+            self._columnsRead.emit(readId, result)
+
+    @Slot(int, object)
+    def _onColumnsRead(self, readId, result):
+        # outdated read
+        if readId != self._readId:
+            return
+        titles, columns, points = result
+        if not titles:
+            return
+        # CsvColumns are created in the main thread
+        self._data.setObjectList([CsvColumn(title, values, columnPoints)
+                                  for title, values, columnPoints in zip(titles, columns, points)])
+        self.setReady(True)
 
     filepathChanged = Signal()
     filepath = Property(str, getFilepath, setFilepath, notify=filepathChanged)
+    maxPointsChanged = Signal()
+    # maximum number of points of the chart series of the columns (0: all values)
+    maxPoints = Property(int, lambda self: self._maxPoints, setMaxPoints, notify=maxPointsChanged)
     readyChanged = Signal()
     ready = Property(bool, lambda self: self._ready, notify=readyChanged)
     data = Property(QObject, lambda self: self._data, notify=readyChanged)
     nbColumns = Property(int, getNbColumns, notify=readyChanged)
+    # emitted from the reading thread
+    _columnsRead = Signal(int, object)
 
 
 class CsvColumn(QObject):
-    """Store content of a CSV column."""
-    def __init__(self, title="", parent=None):
-        """Initialize the object with optional column title parameter."""
+    """Store content of a CSV column as numeric values."""
+    def __init__(self, title="", values=None, points=None, parent=None):
+        """
+        Initialize the object with optional column title, values (array of floats) and
+        (index, value) points displaying them (all values if None).
+        """
         super(CsvColumn, self).__init__(parent=parent)
         self._title = title
-        self._content = []
-
+        self._content = values if values is not None else []
+        self._points = points
     def appendValue(self, value):
-        self._content.append(value)
+        self._content.append(float(value))
 
-    @Slot(result=str)
+    @Slot(result=float)
     def getFirst(self):
         if not self._content:
-            return ""
+            return 0.0
         return self._content[0]
 
-    @Slot(result=str)
+    @Slot(result=float)
     def getLast(self):
         if not self._content:
-            return ""
+            return 0.0
         return self._content[-1]
 
     @Slot(QtCharts.QXYSeries)
     def fillChartSerie(self, serie):
-        """Fill XYSerie used for displaying QML Chart."""
+        """
+        Fill XYSerie used for displaying QML Chart, with the points downsampled when the column was read
+        (see CsvData.maxPoints).
+        """
         if not serie:
             return
-        serie.clear()
-        for index, value in enumerate(self._content):
-            serie.append(float(index), float(value))
+        points = self._points if self._points is not None else downsample(self._content, 0)
+        serie.replace([QPointF(index, value) for index, value in points])
 
     title = Property(str, lambda self: self._title, constant=True)
-    content = Property("QStringList", lambda self: self._content, constant=True)
+    content = Property("QVariantList", lambda self: list(self._content), constant=True)
+    count = Property(int, lambda self: len(self._content), constant=True)
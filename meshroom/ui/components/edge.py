@@ -1,6 +1,6 @@
-from PySide2.QtCore import Signal, Property, QPointF, Qt, QObject
-from PySide2.QtGui import QPainterPath, QVector2D
-from PySide2.QtQuick import QQuickItem
+from PySide2.QtCore import Signal, Property, QPointF, Qt, QObject, QSize, QTimer
+from PySide2.QtGui import QPainterPath, QVector2D, QPen, QColor
+from PySide2.QtQuick import QQuickItem, QQuickPaintedItem
 
 
 class MouseEvent(QObject):
@@ -37,6 +37,9 @@ class EdgeMouseArea(QQuickItem):
         self.setAcceptedMouseButtons(Qt.AllButtons)
 
     def contains(self, point):
+        # shape is only computed when needed for mouse interaction
+        if self._path is None:
+            self.updateShape()
         return self._path.contains(point)
 
     def hoverEnterEvent(self, evt):
@@ -49,7 +52,7 @@ class EdgeMouseArea(QQuickItem):
 
     def geometryChanged(self, newGeometry, oldGeometry):
         super(EdgeMouseArea, self).geometryChanged(newGeometry, oldGeometry)
-        self.updateShape()
+        self._path = None
 
     def mousePressEvent(self, evt):
         if not self.acceptedMouseButtons() & evt.button():
@@ -89,7 +92,7 @@ class EdgeMouseArea(QQuickItem):
             return
         self._thickness = value
         self.thicknessChanged.emit()
-        self.updateShape()
+        self._path = None
 
     def getCurveScale(self):
         return self._curveScale
@@ -99,7 +102,7 @@ class EdgeMouseArea(QQuickItem):
             return
         self._curveScale = value
         self.curveScaleChanged.emit()
-        self.updateShape()
+        self._path = None
 
     def getContainsMouse(self):
         return self._containsMouse
@@ -122,3 +125,153 @@ class EdgeMouseArea(QQuickItem):
 
     pressed = Signal(MouseEvent)
     released = Signal(MouseEvent)
+
+
+class EdgeBatch(QQuickPaintedItem):
+    """
+    Draws all the edges of a graph at once, as node-to-node cubic splines.
+
+    Used as a lightweight representation of the edges when nodes are displayed as simple boxes
+    (see 'Node.simplified'): edges are gathered in a single path that is only rebuilt when the graph
+    topology or nodes positions change, and painted into a single texture.
+    The item covers the bounding box of the nodes, in graph coordinates.
+    """
+    # maximum size of the texture the edges are painted into
+    maxTextureSize = 4096
+
+    def __init__(self, parent=None):
+        super(EdgeBatch, self).__init__(parent)
+        self._graph = None
+        self._nodes = []
+        self._nodeWidth = 160.0
+        self._nodeHeight = 24.0
+        self._color = QColor(Qt.gray)
+        self._textureScale = 1.0
+        self._path = QPainterPath()
+        self._origin = QPointF()
+        self._rebuildScheduled = False
+        self.setAntialiasing(True)
+
+    def paint(self, painter):
+        pen = QPen(self._color)
+        # keep a one pixel wide stroke whatever the texture scale
+        pen.setCosmetic(True)
+        painter.setPen(pen)
+        painter.translate(-self._origin)
+        painter.drawPath(self._path)
+
+    def scheduleRebuild(self):
+        """ Rebuild the edges path on next event loop iteration (multiple requests are merged). """
+        if self._rebuildScheduled:
+            return
+        self._rebuildScheduled = True
+        QTimer.singleShot(0, self._rebuild)
+
+    def _rebuild(self):
+        self._rebuildScheduled = False
+        path = QPainterPath()
+        if self._graph is not None:
+            halfHeight = self._nodeHeight / 2.0
+            ctrlPtDist = 30.0
+            # edges between attributes of the same nodes are drawn only once
+            nodesEdges = set((e.src.node, e.dst.node) for e in self._graph.edges.values())
+            for src, dst in nodesEdges:
+                p1 = QPointF(src.x + self._nodeWidth, src.y + halfHeight)
+                p2 = QPointF(dst.x, dst.y + halfHeight)
+                path.moveTo(p1)
+                path.cubicTo(p1.x() + ctrlPtDist, p1.y(), p2.x() - ctrlPtDist, p2.y(), p2.x(), p2.y())
+        rect = path.boundingRect().adjusted(-1, -1, 1, 1)
+        self._path = path
+        self._origin = rect.topLeft()
+        self.setPosition(self._origin)
+        self.setSize(rect.size())
+        self._updateTextureSize()
+        self.update()
+
+    def _updateTextureSize(self):
+        scale = self._textureScale
+        width, height = self.width() * scale, self.height() * scale
+        if max(width, height) > self.maxTextureSize:
+            ratio = self.maxTextureSize / max(width, height)
+            width, height = width * ratio, height * ratio
+        self.setTextureSize(QSize(max(1, int(width)), max(1, int(height))))
+
+    def _connectNodes(self):
+        for node in self._nodes:
+            node.positionChanged.disconnect(self.scheduleRebuild)
+        self._nodes = list(self._graph.nodes.values()) if self._graph else []
+        for node in self._nodes:
+            node.positionChanged.connect(self.scheduleRebuild)
+
+    def _onNodesChanged(self):
+        self._connectNodes()
+        self.scheduleRebuild()
+
+    def getGraph(self):
+        return self._graph
+
+    def setGraph(self, graph):
+        if self._graph == graph:
+            return
+        if self._graph:
+            self._graph.nodes.countChanged.disconnect(self._onNodesChanged)
+            self._graph.edges.countChanged.disconnect(self.scheduleRebuild)
+        self._graph = graph
+        if self._graph:
+            self._graph.nodes.countChanged.connect(self._onNodesChanged)
+            self._graph.edges.countChanged.connect(self.scheduleRebuild)
+        self._onNodesChanged()
+        self.graphChanged.emit()
+
+    def getNodeWidth(self):
+        return self._nodeWidth
+
+    def setNodeWidth(self, value):
+        if self._nodeWidth == value:
+            return
+        self._nodeWidth = value
+        self.nodeWidthChanged.emit()
+        self.scheduleRebuild()
+
+    def getNodeHeight(self):
+        return self._nodeHeight
+
+    def setNodeHeight(self, value):
+        if self._nodeHeight == value:
+            return
+        self._nodeHeight = value
+        self.nodeHeightChanged.emit()
+        self.scheduleRebuild()
+
+    def getColor(self):
+        return self._color
+
+    def setColor(self, value):
+        if self._color == value:
+            return
+        self._color = value
+        self.colorChanged.emit()
+        self.update()
+
+    def getTextureScale(self):
+        return self._textureScale
+
+    def setTextureScale(self, value):
+        if self._textureScale == value:
+            return
+        self._textureScale = value
+        self.textureScaleChanged.emit()
+        self._updateTextureSize()
+        self.update()
+
+    graphChanged = Signal()
+    graph = Property(QObject, getGraph, setGraph, notify=graphChanged)
+    nodeWidthChanged = Signal()
+    nodeWidth = Property(float, getNodeWidth, setNodeWidth, notify=nodeWidthChanged)
+    nodeHeightChanged = Signal()
+    nodeHeight = Property(float, getNodeHeight, setNodeHeight, notify=nodeHeightChanged)
+    colorChanged = Signal()
+    color = Property(QColor, getColor, setColor, notify=colorChanged)
+    textureScaleChanged = Signal()
+    # scale at which the item is displayed, used to adapt the resolution of the texture
+    textureScale = Property(float, getTextureScale, setTextureScale, notify=textureScaleChanged)
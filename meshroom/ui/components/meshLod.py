@@ -0,0 +1,96 @@
+import logging
+import os
+from multiprocessing.pool import ThreadPool
+from threading import Lock
+
+from PySide2.QtCore import QObject, QUrl, Signal, Slot, Property
+
+from meshroom.core import meshLod
+
+
+class MeshLodHelper(QObject):
+    """
+    Gives access to the levels of detail of 3D media from QML, to display large media progressively
+    (see meshroom.core.meshLod). Missing levels of large media are built in a background thread
+    and stored in a sidecar folder next to the media.
+    Only OBJ media are supported: Alembic media are directly loaded by the qmlAlembic plugin.
+    """
+    # media smaller than this size (in bytes) are directly loaded
+    defaultMinSourceSize = 64 * 1024 * 1024
+    supportedExtensions = ('.obj',)
+
+    def __init__(self, parent=None):
+        super(MeshLodHelper, self).__init__(parent)
+        self._minSourceSize = int(os.environ.get("MESHROOM_LOD_MIN_SIZE", self.defaultMinSourceSize))
+        self._pool = None
+        self._lock = Lock()
+        self._pending = set()
+        self._closed = False
+
+    @staticmethod
+    def _path(source):
+        return source.toLocalFile() if isinstance(source, QUrl) else source
+
+    @Slot(QUrl, result=bool)
+    def isSupported(self, source):
+        """ Whether 'source' is large enough to be displayed progressively and its levels can be built. """
+        path = self._path(source)
+        if os.path.splitext(path)[1].lower() not in self.supportedExtensions:
+            return False
+        try:
+            return os.path.getsize(path) >= self._minSourceSize
+        except OSError:
+            return False
+
+    @Slot(QUrl, result="QVariantList")
+    def levels(self, source):
+        """ Get the sources of the available levels of 'source', from coarsest to finest (excluding 'source'). """
+        return [QUrl.fromLocalFile(p) for p in meshLod.levelPaths(self._path(source))]
+
+    @Slot(QUrl, result=bool)
+    def build(self, source):
+        """
+        Start building the levels of 'source' if they are missing or outdated; 'levelsReady' is emitted once done.
+
+        Returns:
+            bool: whether levels are being built
+        """
+        path = self._path(source)
+        if meshLod.readManifest(path):
+            return False
+        with self._lock:
+            if path in self._pending:
+                return True
+            self._pending.add(path)
+            if self._pool is None:
+                # a single worker: building levels is I/O bound and streams the whole media several times
+                self._pool = ThreadPool(1)
+            self._pool.apply_async(self._build, (path,))
+        return True
+
+    def _build(self, path):
+        """ Build the levels of 'path' (called in the worker thread). """
+        try:
+            meshLod.buildLevels(path, shouldStop=lambda: self._closed)
+        except meshLod.BuildCancelled:
+            return
+        except Exception as e:
+            logging.warning("Failed to build the levels of detail of '{}': {}".format(path, str(e)))
+        finally:
+            with self._lock:
+                self._pending.discard(path)
+        self.levelsReady.emit(QUrl.fromLocalFile(path))
+
+    @Slot()
+    def close(self):
+        """ Stop building levels (partially built levels are discarded). """
+        self._closed = True
+        with self._lock:
+            self._pending.clear()
+            pool, self._pool = self._pool, None
+        if pool is not None:
+            pool.terminate()
+            pool.join()
+
+    levelsReady = Signal(QUrl, arguments=['mediaSource'])
+    minSourceSize = Property(int, lambda self: self._minSourceSize, constant=True)
@@ -52,6 +52,26 @@ class Scene3DHelper(QObject):
             count += sum([attr.count() for attr in geo.attributes() if attr.name() == "vertexColor"])
         return count
 
+    # size in bytes of QAttribute vertex base types
+    _vertexBaseTypeSizes = {
+        Qt3DRender.QAttribute.Byte: 1, Qt3DRender.QAttribute.UnsignedByte: 1,
+        Qt3DRender.QAttribute.Short: 2, Qt3DRender.QAttribute.UnsignedShort: 2, Qt3DRender.QAttribute.HalfFloat: 2,
+        Qt3DRender.QAttribute.Int: 4, Qt3DRender.QAttribute.UnsignedInt: 4, Qt3DRender.QAttribute.Float: 4,
+        Qt3DRender.QAttribute.Double: 8,
+    }
+
+    @Slot(Qt3DCore.QEntity, result=float)
+    def geometrySize(self, entity):
+        """
+        Returns the estimated memory size (in bytes) of the geometries of an entity,
+        based on the number and type of elements of their attributes (vertices, indices...).
+        """
+        size = 0
+        for geo in entity.findChildren(Qt3DRender.QGeometry):
+            for attr in geo.attributes():
+                size += attr.count() * attr.vertexSize() * self._vertexBaseTypeSizes.get(attr.vertexBaseType(), 4)
+        return size
+
 
 class TrackballController(QObject):
     """
@@ -0,0 +1,193 @@
+import json
+import logging
+import os
+
+from PySide2.QtCore import QObject, QPointF, QUrl, Slot, Signal, Property
+from PySide2.QtCharts import QtCharts
+
+from meshroom.core.stats import DownsampledCurve
+
+
+class StatisticsModel(QObject):
+    """
+    Statistics of a NodeChunk read from its statistics file.
+
+    Curves are exposed to QtCharts series registered with 'registerSeries':
+    on each update, only the points resulting from new samples are appended to these series.
+    Long curves are downsampled for display (see DownsampledCurve).
+    """
+    maxPoints = 500
+
+    def __init__(self, parent=None):
+        super(StatisticsModel, self).__init__(parent)
+        self._source = QUrl()
+        self._fileKey = None
+        self._startTime = None
+        self._cpuAverage = []
+        self._curves = {}  # curve name -> DownsampledCurve
+        self._series = {}  # curve name -> list of QXYSeries
+        self._reset()
+
+    def _reset(self):
+        self._fileKey = None
+        self._startTime = None
+        self._cpuAverage = []
+        self._curves = {}
+        self._series = {}
+        self._fileVersion = 0.0
+        self._interval = 10
+        self._nbSamples = 0
+        self._nbCores = 0
+        self._cpuFrequency = 0
+        self._ramTotal = 0
+        self._ramMaxPeak = False
+        self._gpuTotalMemory = 0
+        self._gpuName = ''
+        self._gpuMaxValue = 100
+
+    def getSource(self):
+        return self._source
+
+    def setSource(self, source):
+        if self._source == source:
+            return
+        self._source = source
+        self._reset()
+        self.sourceChanged.emit()
+        self.curvesChanged.emit()
+        self.update()
+
+    @Slot()
+    def update(self):
+        """ Reload the statistics file if it has changed and append new samples to the registered series. """
+        filepath = self._source.toLocalFile()
+        try:
+            fileStat = os.stat(filepath)
+        except OSError:
+            if self._fileKey is not None:
+                self._reset()
+                self.curvesChanged.emit()
+                self.statisticsChanged.emit()
+            return
+        fileKey = (fileStat.st_mtime, fileStat.st_size)
+        if fileKey == self._fileKey:
+            return
+        self._fileKey = fileKey
+        try:
+            with open(filepath, 'r') as f:
+                data = json.load(f)
+        except (IOError, ValueError) as e:
+            logging.warning("Failed to parse statistics file: {}\n{}".format(filepath, str(e)))
+            return
+
+        times = data.get('times', [])
+        startTime = times[0] if times else None
+        newRun = startTime != self._startTime
+        if newRun:
+            # statistics of a new computation
+            self._reset()
+            self._fileKey = fileKey
+            self._startTime = startTime
+
+        computer = data.get('computer', {})
+        self._fileVersion = data.get('fileVersion', 0.0)
+        self._interval = data.get('interval', 30)
+        self._cpuFrequency = computer.get('cpuFreq', -1)
+        self._ramTotal = computer.get('ramTotal', -1)
+        self._gpuTotalMemory = computer.get('gpuMemoryTotal', 0)
+        self._gpuName = computer.get('gpuName', '')
+
+        curves = self._getCurves(computer.get('curves', {}))
+        self._nbSamples = max([len(samples) for samples in curves.values()] or [0])
+        for name, samples in curves.items():
+            curve = self._curves.get(name)
+            if curve is None:
+                curve = self._curves[name] = DownsampledCurve(self.maxPoints)
+            previousCount = len(curve.samples)
+            rebuilt, newPoints = curve.update(samples)
+            if name == 'gpuTemperature' and curve.samples:
+                self._gpuMaxValue = max(100, max(curve.samples[previousCount:] or [0]), self._gpuMaxValue)
+            for series in self._series.get(name, []):
+                # single samples are displayed as a segment: replace it when new samples arrive
+                if rebuilt or previousCount <= 1:
+                    series.replace(self._seriesPoints(curve))
+                else:
+                    for x, y in newPoints:
+                        series.append(x * self.intervalMinutes, y)
+
+        if newRun:
+            self.curvesChanged.emit()
+        self.statisticsChanged.emit()
+
+    def _getCurves(self, computerCurves):
+        """ Get the samples of the displayed curves from statistics file curves. """
+        curves = {}
+        cpuCurves = []
+        while "cpuUsage.{}".format(len(cpuCurves)) in computerCurves:
+            cpuCurves.append(computerCurves["cpuUsage.{}".format(len(cpuCurves))])
+        self._nbCores = len(cpuCurves)
+        for i, samples in enumerate(cpuCurves):
+            curves["cpuUsage.{}".format(i)] = samples
+        if cpuCurves:
+            # average is only computed for new samples
+            nbSamples = min(len(samples) for samples in cpuCurves)
+            for i in range(len(self._cpuAverage), nbSamples):
+                self._cpuAverage.append(sum(float(samples[i]) for samples in cpuCurves) / len(cpuCurves))
+            curves["cpuAverage"] = self._cpuAverage
+
+        ram = computerCurves.get('ramUsage', [])
+        curves['ramUsage'] = ram
+        if self._ramTotal <= 0 and ram:
+            # use RAM max peak when total is unknown
+            self._ramTotal = max(float(v) for v in ram)
+            self._ramMaxPeak = True
+
+        gpuMemoryRatio = 100.0 / self._gpuTotalMemory if self._gpuTotalMemory > 0 else 1
+        for name in ('gpuUsed', 'gpuMemoryUsed', 'gpuTemperature'):
+            samples = computerCurves.get(name, [])
+            if name == 'gpuMemoryUsed':
+                samples = [float(v) * gpuMemoryRatio for v in samples]
+            curves[name] = samples
+        return curves
+
+    def _seriesPoints(self, curve):
+        if len(curve.samples) == 1:
+            # create 2 points to display a segment
+            return [QPointF(0, curve.samples[0]), QPointF(self.intervalMinutes, curve.samples[0])]
+        return [QPointF(x * self.intervalMinutes, y) for x, y in curve.points]
+
+    @Slot(str, QtCharts.QXYSeries)
+    def registerSeries(self, name, series):
+        """ Fill 'series' with the points of the curve 'name' and keep it updated with new samples. """
+        curve = self._curves.get(name)
+        series.replace(self._seriesPoints(curve) if curve else [])
+        self._series.setdefault(name, []).append(series)
+        series.destroyed.connect(lambda: self._unregisterSeries(name, series))
+
+    def _unregisterSeries(self, name, series):
+        try:
+            self._series.get(name, []).remove(series)
+        except ValueError:
+            pass
+
+    @property
+    def intervalMinutes(self):
+        return self._interval / 60.0
+
+    sourceChanged = Signal()
+    source = Property(QUrl, getSource, setSource, notify=sourceChanged)
+    # emitted when the set of curves is reset (new source or new computation): series have to be registered again
+    curvesChanged = Signal()
+    statisticsChanged = Signal()
+    fileVersion = Property(float, lambda self: self._fileVersion, notify=statisticsChanged)
+    # interval between samples in minutes
+    deltaTime = Property(float, lambda self: self.intervalMinutes, notify=statisticsChanged)
+    nbReads = Property(int, lambda self: max(0, self._nbSamples - 1), notify=statisticsChanged)
+    nbCores = Property(int, lambda self: self._nbCores, notify=statisticsChanged)
+    cpuFrequency = Property(float, lambda self: self._cpuFrequency, notify=statisticsChanged)
+    ramTotal = Property(float, lambda self: self._ramTotal, notify=statisticsChanged)
+    # whether 'ramTotal' is the maximum RAM usage peak (total RAM being unknown)
+    ramMaxPeak = Property(bool, lambda self: self._ramMaxPeak, notify=statisticsChanged)
+    gpuTotalMemory = Property(float, lambda self: self._gpuTotalMemory, notify=statisticsChanged)
+    gpuName = Property(str, lambda self: self._gpuName, notify=statisticsChanged)
+    gpuMaxValue = Property(float, lambda self: self._gpuMaxValue, notify=statisticsChanged)
@@ -0,0 +1,107 @@
+from PySide2.QtCore import QAbstractListModel, QModelIndex, Qt, QUrl, Slot, Signal, Property
+
+from meshroom.core.textFile import TextFileIndex
+
+
+class TextFileModel(QAbstractListModel):
+    """
+    List model exposing the lines of a text file, that can be followed while it grows (e.g. a log file).
+    Each update only reads the bytes appended to the file and lines content is only read when displayed.
+    """
+    LineRole = Qt.UserRole + 1
+
+    def __init__(self, parent=None):
+        super(TextFileModel, self).__init__(parent)
+        self._source = QUrl()
+        self._index = TextFileIndex()
+        # number of rows announced to the views: lines indexed by an update are inserted afterwards
+        self._rowCount = 0
+
+    def rowCount(self, parent=QModelIndex()):
+        if parent.isValid():
+            return 0
+        return self._rowCount
+
+    def data(self, index, role=Qt.DisplayRole):
+        if not index.isValid() or index.row() >= self._rowCount:
+            return None
+        if role in (Qt.DisplayRole, TextFileModel.LineRole):
+            return self._index.line(index.row())
+        return None
+
+    def roleNames(self):
+        return {TextFileModel.LineRole: b"line"}
+
+    def getSource(self):
+        return self._source
+
+    def setSource(self, source):
+        if self._source == source:
+            return
+        self._source = source
+        self.beginResetModel()
+        self._index.setFilepath(source.toLocalFile())
+        self._index.update()
+        self._rowCount = self._index.lineCount
+        self.endResetModel()
+        self.sourceChanged.emit()
+        self.contentChanged.emit()
+
+    @Slot()
+    def update(self):
+        """ Read the lines appended to the file since the previous update and refresh the lines rewritten in place. """
+        previousCount = self._rowCount
+        # appended lines are indexed after the announced rows, which are not affected until they are inserted
+        result = self._index.update()
+        if result is None:
+            return
+        reset, firstModifiedLine = result
+        count = self._index.lineCount
+        if reset:
+            self.beginResetModel()
+            self._rowCount = count
+            self.endResetModel()
+        else:
+            if firstModifiedLine < previousCount:
+                self.dataChanged.emit(self.index(firstModifiedLine), self.index(previousCount - 1))
+            if count > previousCount:
+                self.beginInsertRows(QModelIndex(), previousCount, count - 1)
+                self._rowCount = count
+                self.endInsertRows()
+        self.contentChanged.emit()
+
+    @Slot(result=int)
+    def loadOlder(self):
+        """ Load lines preceding the first loaded one. Returns the number of inserted lines. """
+        if not self._index.hasOlderLines:
+            return 0
+        # older lines shift the indices of the existing rows: read them before announcing their insertion
+        starts = self._index.readOlderLines()
+        if not starts:
+            return 0
+        self.beginInsertRows(QModelIndex(), 0, len(starts) - 1)
+        inserted = self._index.insertOlderLines(starts)
+        self._rowCount = self._index.lineCount
+        self.endInsertRows()
+        self.contentChanged.emit()
+        return inserted
+
+    @Slot(int, result=str)
+    def line(self, index):
+        return self._index.line(index)
+
+    @Slot(int, int, result=str)
+    def text(self, first, last):
+        """ Get the text from line 'first' to line 'last' (included). """
+        return self._index.text(first, last)
+
+    @Slot(str, int, bool, result=int)
+    def find(self, text, fromLine, backward):
+        """ Get the index of the next line containing 'text' (case insensitive), -1 if not found. """
+        return self._index.find(text, fromLine, backward)
+
+    sourceChanged = Signal()
+    source = Property(QUrl, getSource, setSource, notify=sourceChanged)
+    contentChanged = Signal()
+    count = Property(int, lambda self: self._rowCount, notify=contentChanged)
+    hasOlderLines = Property(bool, lambda self: self._index.hasOlderLines, notify=contentChanged)
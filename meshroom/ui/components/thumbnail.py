@@ -0,0 +1,106 @@
+import logging
+import os
+
+from PySide2.QtCore import QObject, QStandardPaths, QTimer, QUrl, Qt, Slot, Property
+from PySide2.QtGui import QImage, QImageReader
+from PySide2.QtQuick import QQuickAsyncImageProvider, QQuickImageResponse, QQuickTextureFactory
+
+from meshroom.core.thumbnails import ThumbnailCache
+
+
+def createThumbnail(imagePath, thumbnailPath, maxSize=256):
+    """
+    Write a downscaled version of 'imagePath' to 'thumbnailPath'.
+    Relies on the scaled decoding of image plugins when available (e.g. JPEG) to avoid decoding full resolution images.
+    """
+    reader = QImageReader(imagePath)
+    reader.setAutoTransform(True)
+    size = reader.size()
+    if size.isValid() and (size.width() > maxSize or size.height() > maxSize):
+        reader.setScaledSize(size.scaled(maxSize, maxSize, Qt.KeepAspectRatio))
+    image = reader.read()
+    if image.isNull():
+        logging.debug("Failed to read image '{}': {}".format(imagePath, reader.errorString()))
+        return False
+    if image.width() > maxSize or image.height() > maxSize:
+        # image plugin does not support scaled decoding
+        image = image.scaled(maxSize, maxSize, Qt.KeepAspectRatio, Qt.SmoothTransformation)
+    return image.save(thumbnailPath, "JPEG", 90)
+
+
+class ThumbnailImageResponse(QQuickImageResponse):
+    """ Response to the request of a thumbnail, finished once the thumbnail is in the cache (or failed). """
+
+    def __init__(self, cache, imagePath):
+        super(ThumbnailImageResponse, self).__init__()
+        self._cache = cache
+        self._imagePath = imagePath
+        if cache.request(imagePath, self._onDone) is None:
+            # cached thumbnail: finish once the response has been returned to the image loading thread
+            QTimer.singleShot(0, self._onDone)
+
+    def _onDone(self):
+        try:
+            self.finished.emit()
+        except RuntimeError:
+            # response already deleted (request cancelled)
+            pass
+
+    def textureFactory(self):
+        # called from the image loading thread
+        thumbnailPath = self._cache.cached(self._imagePath)
+        return QQuickTextureFactory.textureFactoryForImage(QImage(thumbnailPath) if thumbnailPath else QImage())
+
+
+class ThumbnailImageProvider(QQuickAsyncImageProvider):
+    """
+    Image provider serving the thumbnails of a ThumbnailCache (see ThumbnailHelper.source).
+    Requests never wait for the thumbnail creation: their response is finished by the cache worker threads,
+    so cached thumbnails are served while others are being created.
+    """
+
+    def __init__(self, cache):
+        super(ThumbnailImageProvider, self).__init__()
+        self._cache = cache
+
+    def requestImageResponse(self, id, requestedSize):
+        return ThumbnailImageResponse(self._cache, QUrl.fromPercentEncoding(id.encode('utf-8')))
+
+
+class ThumbnailHelper(QObject):
+    """
+    Gives access to image thumbnails from QML: thumbnails are created on a pool of threads,
+    stored in a persistent cache folder and loaded through the "thumbnails" image provider.
+    """
+    providerId = "thumbnails"
+
+    def __init__(self, parent=None):
+        super(ThumbnailHelper, self).__init__(parent)
+        cacheDir = os.environ.get("MESHROOM_THUMBNAIL_DIR",
+                                  os.path.join(QStandardPaths.writableLocation(QStandardPaths.CacheLocation), "thumbnails"))
+        self._cache = ThumbnailCache(cacheDir, createThumbnail)
+
+    def imageProvider(self):
+        """ Create the image provider to add to the QML engine with 'providerId'. """
+        return ThumbnailImageProvider(self._cache)
+
+    @Slot(QUrl, result=QUrl)
+    def source(self, imageSource):
+        """ Get the source of the thumbnail of 'imageSource' to use in an Image. """
+        if imageSource.isEmpty():
+            return QUrl()
+        path = QUrl.toPercentEncoding(imageSource.toLocalFile()).data().decode('utf-8')
+        return QUrl("image://{}/{}".format(self.providerId, path))
+
+    @Slot("QVariantList")
+    def prefetch(self, imagePaths):
+        """ Create the thumbnails of 'imagePaths' ahead of their display (replaces the previous prefetch). """
+        self._cache.prefetch(imagePaths)
+
+    @Slot()
+    def close(self):
+        """ Stop thumbnails creation and remove the oldest thumbnails if the cache folder is too large. """
+        self._cache.close()
+        self._cache.cleanup()
+
+    cacheDir = Property(str, lambda self: self._cache.cacheDir, constant=True)
@@ -13,6 +13,7 @@ from meshroom import multiview
 from meshroom.common.qt import QObjectListModel
 from meshroom.core.attribute import Attribute, ListAttribute
 from meshroom.core.graph import Graph, Edge
+from meshroom.core.layout import orderLayers
 
 from meshroom.core.taskManager import TaskManager
 
@@ -133,6 +134,9 @@ class ChunksMonitor(QObject):
             # update chunk status if last modification time has changed since previous record
             if fileModTime != chunk.statusFileLastModTime:
                 chunk.updateStatusFromCache()
+            # read new progress records of running chunks
+            if chunk.status.status == Status.RUNNING:
+                chunk.updateProgressFromCache()
 
 
 class GraphLayout(QObject):
@@ -176,21 +180,29 @@ class GraphLayout(QObject):
         def getDepth(n):
             return getattr(n, self._depthAttribute[self._depthMode])
 
-        maxDepth = max([getDepth(n) for n in self.graph.nodes.values()])
+        t = time.time()
+        nodes = list(self.graph.nodes.values())
+        maxDepth = max([getDepth(n) for n in nodes])
         grid = [[] for _ in range(maxDepth + 1)]
 
         # retrieve reference depth from start node
-        zeroDepth = getDepth(self.graph.nodes.at(fromIndex)) if fromIndex > 0 else 0
-        for i in range(fromIndex, toIndex + 1):
-            n = self.graph.nodes.at(i)
+        zeroDepth = getDepth(nodes[fromIndex]) if fromIndex > 0 else 0
+        for n in nodes[fromIndex:toIndex + 1]:
             grid[getDepth(n) - zeroDepth].append(n)
 
-        with self.graph.groupedGraphModification("Graph Auto-Layout"):
-            for x, line in enumerate(grid):
-                for y, node in enumerate(line):
-                    px = startX + x * (self._nodeWidth + self._gridSpacing)
-                    py = startY + y * (self._nodeHeight + self._gridSpacing)
-                    self.graph.moveNode(node, Position(px, py))
+        # reduce edge crossings between columns
+        nodesEdges = set((e.src.node, e.dst.node) for e in self.graph.graph.edges.values())
+        grid = orderLayers(grid, nodesEdges)
+
+        positions = {}
+        for x, line in enumerate(grid):
+            for y, node in enumerate(line):
+                px = startX + x * (self._nodeWidth + self._gridSpacing)
+                py = startY + y * (self._nodeHeight + self._gridSpacing)
+                positions[node] = Position(px, py)
+        # apply all positions at once, as a single undoable command
+        self.graph.moveNodes(positions, "Graph Auto-Layout")
+        logging.debug("Graph Auto-Layout: {} nodes in {:.3f}s".format(len(positions), time.time() - t))
 
     @Slot()
     def reset(self):
@@ -208,7 +220,7 @@ class GraphLayout(QObject):
             list of int: the resulting bounding box (x, y, width, height)
         """
         if nodes is None:
-            nodes = self.graph.nodes.values()
+            nodes = list(self.graph.nodes.values())
         first = nodes[0]
         bbox = [first.x, first.y, first.x, first.y]
         for n in nodes:
@@ -512,6 +524,16 @@ class UIGraph(QObject):
             position = Position(position.x(), position.y())
         self.push(commands.MoveNodeCommand(self._graph, node, position))
 
+    def moveNodes(self, positions, title="Move Nodes"):
+        """
+        Move several nodes at once.
+
+        Args:
+            positions (dict): the target Position of each Node
+            title (str): the title of the undoable command
+        """
+        self.push(commands.MoveNodesCommand(self._graph, positions, title))
+
     @Slot(Node)
     def removeNode(self, node):
         self.push(commands.RemoveNodeCommand(self._graph, node))
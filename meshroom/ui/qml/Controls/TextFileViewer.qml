@@ -2,12 +2,15 @@ import QtQuick 2.11
 import QtQuick.Controls 2.4
 import QtQuick.Layouts 1.11
 import MaterialIcons 2.2
+import DataObjects 1.0
 
 import Utils 1.0
 
 /**
  * Text file viewer with auto-reload feature.
  * Uses a ListView with one delegate by line instead of a TextArea for performance reasons.
+ * File content is provided by a TextFileModel: each reload only reads the appended part of the file,
+ * starting with the end of the file, older lines being loaded when scrolling to the top.
  */
 Item {
     id: root
@@ -25,6 +28,10 @@ Item {
     onAutoReloadChanged: loadSource()
     onVisibleChanged: if(visible) loadSource()
 
+    TextFileModel {
+        id: textFileModel
+    }
+
     RowLayout {
         anchors.fill: parent
         spacing: 0
@@ -48,6 +55,12 @@ Item {
                     ToolTip.text: "Scroll to Top"
                     onClicked: textView.positionViewAtBeginning()
                 }
+                MaterialToolButton {
+                    text: MaterialIcons.expand_less
+                    ToolTip.text: "Load Previous Lines"
+                    visible: textFileModel.hasOlderLines
+                    onClicked: textView.loadOlderLines()
+                }
                 MaterialToolButton {
                     id: autoscroll
                     text: MaterialIcons.vertical_align_bottom
@@ -67,20 +80,28 @@ Item {
                         MenuItem {
                             text: "Copy Visible Text"
                             onTriggered: {
-                                var t = "";
-                                for(var i = textView.firstVisibleIndex(); i < textView.lastVisibleIndex(); ++i)
-                                    t += textView.model[i] + "\n";
-                                Clipboard.setText(t);
+                                Clipboard.setText(textFileModel.text(textView.firstVisibleIndex(), textView.lastVisibleIndex()));
                             }
                         }
                         MenuItem {
                             text: "Copy All"
                             onTriggered: {
-                                Clipboard.setText(textView.text);
+                                Clipboard.setText(textFileModel.text(0, textFileModel.count - 1));
                             }
                          }
                     }
                 }
+                MaterialToolButton {
+                    text: MaterialIcons.search
+                    ToolTip.text: "Search"
+                    checkable: true
+                    checked: searchBar.visible
+                    onClicked: {
+                        searchBar.visible = checked
+                        if(checked)
+                            searchBar.forceActiveFocus()
+                    }
+                }
                 MaterialToolButton {
                     text: MaterialIcons.open_in_new
                     ToolTip.text: "Open Externally"
@@ -98,11 +119,8 @@ Item {
             ListView {
                 id: textView
 
-                property string text
-
-                // model consists in text split by line
-                model: textView.text.split("\n")
-                visible: text != ""
+                model: textFileModel
+                visible: count > 0
 
                 anchors.fill: parent
                 clip: true
@@ -138,21 +156,24 @@ Item {
                     }
                 }
 
-                function setText(value) {
-                    // store current first index
+                // load older lines when reaching the top of the loaded part of the file
+                onAtYBeginningChanged: if(atYBeginning && textFileModel.hasOlderLines) loadOlderLines()
+
+                function loadOlderLines() {
                     var topIndex = firstVisibleIndex();
-                    // store whether autoscroll to bottom is active
-                    var scrollToBottom = atYEnd && autoscroll.checked;
-                    // replace text
-                    text = value;
-
-                    // restore content position by either:
-                    //  - autoscrolling to bottom
-                    if(scrollToBottom)
-                        positionViewAtEnd();
-                    //  - setting first visible index back (when possible)
-                    else if(topIndex !== firstVisibleIndex())
-                        positionViewAtIndex(Math.min(topIndex, count-1), ListView.Beginning);
+                    var inserted = textFileModel.loadOlder();
+                    // keep displaying the same lines
+                    positionViewAtIndex(Math.max(topIndex, 0) + inserted, ListView.Beginning);
+                }
+
+                /// Select the next line matching the search text, from the current one
+                function findNext(backward) {
+                    var from = currentIndex >= 0 ? currentIndex : firstVisibleIndex();
+                    var index = textFileModel.find(searchBar.text, backward ? from - 1 : from + 1, backward);
+                    if(index < 0)
+                        return;
+                    currentIndex = index;
+                    positionViewAtIndex(index, ListView.Center);
                 }
 
                 function firstVisibleIndex() {
@@ -170,6 +191,8 @@ Item {
 
                 ScrollBar.horizontal: ScrollBar { minimumSize: 0.1 }
 
+                highlight: Rectangle { color: Colors.sysPalette.highlight; opacity: 0.3 }
+
                 // TextMetrics for line numbers column
                 TextMetrics {
                     id: lineMetrics
@@ -212,8 +235,8 @@ Item {
                                 State {
                                     name: "progressBar"
                                     // detect textual progressbar (non empty line with only progressbar character)
-                                    when: modelData.trim().length
-                                          && modelData.split(progressMetrics.character).length - 1 === modelData.trim().length
+                                    when: model.line.trim().length
+                                          && model.line.split(progressMetrics.character).length - 1 === model.line.trim().length
                                     PropertyChanges {
                                         target: delegateLoader
                                         sourceComponent: progressBar_component
@@ -234,7 +257,7 @@ Item {
                                     anchors.verticalCenter: parent.verticalCenter
                                     from: 0
                                     to: progressMetrics.count
-                                    value: modelData.length
+                                    value: model.line.trim().length
                                 }
                             }
                         }
@@ -244,7 +267,7 @@ Item {
                             id: line_component
                             TextInput {
                                 wrapMode: Text.WrapAnywhere
-                                text: modelData
+                                text: model.line
                                 font.family: "Monospace, Consolas, Monaco"
                                 padding: 0
                                 selectByMouse: true
@@ -285,6 +308,37 @@ Item {
                 }
             }
 
+            // Search
+            Pane {
+                anchors.top: parent.top
+                anchors.right: parent.right
+                anchors.rightMargin: vScrollBar.width
+                width: 300
+                padding: 2
+                visible: searchBar.visible
+                RowLayout {
+                    width: parent.width
+                    spacing: 0
+                    SearchBar {
+                        id: searchBar
+                        Layout.fillWidth: true
+                        visible: false
+                        textField.onAccepted: textView.findNext(false)
+                        Keys.onEscapePressed: visible = false
+                    }
+                    MaterialToolButton {
+                        text: MaterialIcons.keyboard_arrow_up
+                        ToolTip.text: "Previous"
+                        onClicked: textView.findNext(true)
+                    }
+                    MaterialToolButton {
+                        text: MaterialIcons.keyboard_arrow_down
+                        ToolTip.text: "Next"
+                        onClicked: textView.findNext(false)
+                    }
+                }
+            }
+
             // File loading indicator
             BusyIndicator {
                 Component.onCompleted: running = Qt.binding(function() { return root.loading })
@@ -307,28 +361,30 @@ Item {
     }
 
 
-    // Load current source file and update ListView's model
+    // Load current source file or its appended content and update ListView's model
     function loadSource()
     {
         if(!visible)
             return;
 
         loading = true;
-        var xhr = new XMLHttpRequest;
-
-        xhr.open("GET", root.source);
-        xhr.onreadystatechange = function() {
-            // - can't rely on 'Last-Modified' header response to verify
-            //   that file has changed on disk (not always up-to-date)
-            // - instead, let QML engine evaluate whether 'text' property value has changed
-            if(xhr.readyState === XMLHttpRequest.DONE) {
-                textView.setText(xhr.status === 200 ? xhr.responseText : "");
-                loading = false;
-                // re-trigger reload source file
-                if(autoReload)
-                    reloadTimer.restart();
-            }
-        };
-        xhr.send();
+        // store whether autoscroll to bottom is active
+        var scrollToBottom = textView.atYEnd && autoscroll.checked;
+        if(textFileModel.source.toString() !== root.source.toString())
+        {
+            textFileModel.source = root.source;
+            scrollToBottom = true;
+        }
+        else
+            textFileModel.update();
+
+        // restore content position by autoscrolling to bottom
+        // (first visible line is kept otherwise, as lines are only appended)
+        if(scrollToBottom)
+            textView.positionViewAtEnd();
+        loading = false;
+        // re-trigger reload source file
+        if(autoReload)
+            reloadTimer.restart();
     }
 }
@@ -16,6 +16,15 @@ Item {
     property variant nodeTypesModel: null  /// the list of node types that can be instantiated
 
     property var _attributeToDelegate: ({})
+    property var _nodeToDelegate: ({})
+
+    /// Zoom level under which nodes are displayed as simple boxes and edges are drawn in a single batch
+    property real simplifiedZoom: 0.4
+    readonly property bool simplified: draggable.scale < simplifiedZoom
+    /// Height of the nodes in simplified mode
+    property real simplifiedNodeHeight: 24
+    /// Area of the graph (in 'draggable' coordinates) in which node delegates are instantiated
+    property rect loadedArea: Qt.rect(0, 0, 0, 0)
 
     // signals
     signal workspaceMoved()
@@ -43,12 +52,7 @@ Item {
     /// Get node delegate for the given node object
     function nodeDelegate(node)
     {
-        for(var i=0; i<nodeRepeater.count; ++i)
-        {
-            if(nodeRepeater.itemAt(i).node === node)
-                return nodeRepeater.itemAt(i)
-        }
-        return undefined
+        return _nodeToDelegate[node]
     }
 
     /// Select node delegate
@@ -64,6 +68,39 @@ Item {
     }
 
 
+    // update the loaded area at a limited rate while the view is moving
+    Timer {
+        id: loadedAreaTimer
+        interval: 50
+        onTriggered: updateLoadedArea()
+    }
+
+    onWidthChanged: loadedAreaTimer.start()
+    onHeightChanged: loadedAreaTimer.start()
+
+    /// Update the area in which node delegates are instantiated to cover the visible part of the graph
+    function updateLoadedArea()
+    {
+        var s = draggable.scale
+        var view = Qt.rect(-draggable.x / s, -draggable.y / s, root.width / s, root.height / s)
+        var area = loadedArea
+        // keep the current area as long as it contains the view and is not much larger
+        if(view.x >= area.x && view.y >= area.y
+           && view.x + view.width <= area.x + area.width && view.y + view.height <= area.y + area.height
+           && area.width < 3 * view.width)
+            return
+        // add a margin of half the view size around it for a seamless panning
+        loadedArea = Qt.rect(view.x - view.width * 0.5, view.y - view.height * 0.5, view.width * 2, view.height * 2)
+    }
+
+    /// Whether the given rectangle (in 'draggable' coordinates) intersects the loaded area
+    function intersectsLoadedArea(x, y, width, height)
+    {
+        var area = loadedArea
+        return x < area.x + area.width && x + width > area.x
+               && y < area.y + area.height && y + height > area.y
+    }
+
     Keys.onPressed: {
         if(event.key === Qt.Key_F)
             fit()
@@ -218,6 +255,10 @@ Item {
             width: 1000
             height: 1000
 
+            onXChanged: loadedAreaTimer.start()
+            onYChanged: loadedAreaTimer.start()
+            onScaleChanged: loadedAreaTimer.start()
+
             Menu {
                 id: edgeMenu
                 property var currentEdge: null
@@ -228,6 +269,17 @@ Item {
                 }
             }
 
+            // Edges, batched in a single item when nodes are simplified
+            EdgeBatch {
+                visible: root.simplified
+                graph: visible ? root.graph : null
+                nodeWidth: uigraph.layout.nodeWidth
+                nodeHeight: root.simplifiedNodeHeight
+                color: activePalette.text
+                opacity: 0.7
+                textureScale: draggable.scale
+            }
+
             // Edges
             Repeater {
                 id: edgesRepeater
@@ -235,33 +287,47 @@ Item {
                 // delay edges loading after nodes (edges needs attribute pins to be created)
                 model: nodeRepeater.loaded && root.graph ? root.graph.edges : undefined
 
-                delegate: Edge {
-                    property var src: root._attributeToDelegate[edge.src]
-                    property var dst: root._attributeToDelegate[edge.dst]
-                    property bool isValidEdge: src != undefined && dst != undefined
-                    visible: isValidEdge
-
-                    property bool inFocus: containsMouse || (edgeMenu.opened && edgeMenu.currentEdge == edge)
-
-                    edge: object
-                    color: inFocus ? activePalette.highlight : activePalette.text
-                    thickness: inFocus ? 2 : 1
-                    opacity: 0.7
-                    point1x: isValidEdge ? src.globalX + src.outputAnchorPos.x : 0
-                    point1y: isValidEdge ? src.globalY + src.outputAnchorPos.y : 0
-                    point2x: isValidEdge ? dst.globalX + dst.inputAnchorPos.x : 0
-                    point2y: isValidEdge ? dst.globalY + dst.inputAnchorPos.y : 0
-                    onPressed: {
-                        const canEdit = !edge.dst.node.locked
-
-                        if(event.button == Qt.RightButton)
-                        {
-                            if(canEdit && (event.modifiers & Qt.AltModifier)) {
-                                uigraph.removeEdge(edge)
-                            }
-                            else {
-                                edgeMenu.currentEdge = edge
-                                edgeMenu.popup()
+                // only instantiate edges connected to at least one visible node
+                delegate: Loader {
+                    id: edgeLoader
+                    readonly property var edge: object
+                    readonly property var srcNode: root._nodeToDelegate[edge.src.node]
+                    readonly property var dstNode: root._nodeToDelegate[edge.dst.node]
+
+                    active: !root.simplified && srcNode !== undefined && dstNode !== undefined
+                            && (!srcNode.culled || !dstNode.culled)
+
+                    sourceComponent: Component {
+                        Edge {
+                            // attribute pins are re-evaluated when pins of their node are created/deleted
+                            property var src: edgeLoader.srcNode.pinsRevision >= 0 ? root._attributeToDelegate[edge.src] : undefined
+                            property var dst: edgeLoader.dstNode.pinsRevision >= 0 ? root._attributeToDelegate[edge.dst] : undefined
+                            // an edge connected to a culled node is anchored on the node bounds
+                            visible: (src !== undefined || edgeLoader.srcNode.culled) && (dst !== undefined || edgeLoader.dstNode.culled)
+
+                            property bool inFocus: containsMouse || (edgeMenu.opened && edgeMenu.currentEdge == edge)
+
+                            edge: edgeLoader.edge
+                            color: inFocus ? activePalette.highlight : activePalette.text
+                            thickness: inFocus ? 2 : 1
+                            opacity: 0.7
+                            point1x: src ? src.globalX + src.outputAnchorPos.x : edgeLoader.srcNode.x + edgeLoader.srcNode.width
+                            point1y: src ? src.globalY + src.outputAnchorPos.y : edgeLoader.srcNode.y + root.simplifiedNodeHeight / 2
+                            point2x: dst ? dst.globalX + dst.inputAnchorPos.x : edgeLoader.dstNode.x
+                            point2y: dst ? dst.globalY + dst.inputAnchorPos.y : edgeLoader.dstNode.y + root.simplifiedNodeHeight / 2
+                            onPressed: {
+                                const canEdit = !edge.dst.node.locked
+
+                                if(event.button == Qt.RightButton)
+                                {
+                                    if(canEdit && (event.modifiers & Qt.AltModifier)) {
+                                        uigraph.removeEdge(edge)
+                                    }
+                                    else {
+                                        edgeMenu.currentEdge = edge
+                                        edgeMenu.popup()
+                                    }
+                                }
                             }
                         }
                     }
@@ -418,6 +484,13 @@ Item {
                     node: object
                     width: uigraph.layout.nodeWidth
 
+                    culled: !root.intersectsLoadedArea(x, y, width, detailedHeight)
+                    simplified: root.simplified
+                    simplifiedHeight: root.simplifiedNodeHeight
+
+                    Component.onCompleted: root._nodeToDelegate[node] = nodeDelegate
+                    Component.onDestruction: delete root._nodeToDelegate[node]
+
                     selected: uigraph.selectedNode === node
                     hovered: uigraph.hoveredNode === node
                     onSelectedChanged: if(selected) forceActiveFocus()
@@ -26,6 +26,16 @@ Item {
     property color shadowColor: "#cc000000"
     readonly property color defaultColor: isCompatibilityNode ? "#444" : activePalette.base
     property color baseColor: defaultColor
+    /// Whether the node is outside of the visible area (no visual representation is instantiated)
+    property bool culled: false
+    /// Whether the node is displayed as a simple box, without its attributes
+    property bool simplified: false
+    /// Height of the simplified representation
+    property real simplifiedHeight: 24
+    /// Last known height of the detailed representation, used while it is not instantiated
+    property real detailedHeight: simplifiedHeight
+    /// Incremented each time an attribute pin is created or deleted
+    property int pinsRevision: 0
 
     Item {
         id: m
@@ -51,7 +61,7 @@ Item {
     x: root.node ? root.node.x : undefined
     y: root.node ? root.node.y : undefined
 
-    implicitHeight: childrenRect.height
+    implicitHeight: contentLoader.item ? contentLoader.item.height : (simplified ? simplifiedHeight : detailedHeight)
 
     SystemPalette { id: activePalette }
 
@@ -64,6 +74,9 @@ Item {
         }
     }
 
+    onAttributePinCreated: pinsRevision++
+    onAttributePinDeleted: pinsRevision++
+
     // Whether an attribute can be displayed as an attribute pin on the node
     function isFileAttributeBaseType(attribute) {
         // ATM, only File attributes are meant to be connected
@@ -94,7 +107,7 @@ Item {
     // Main Layout
     MouseArea {
         width: parent.width
-        height: body.height
+        height: root.height
         drag.target: root
         // small drag threshold to avoid moving the node by mistake
         drag.threshold: 2
@@ -113,304 +126,343 @@ Item {
 
         cursorShape: drag.active ? Qt.ClosedHandCursor : Qt.ArrowCursor
 
-        // Selection border
-        Rectangle {
-            anchors.fill: nodeContent
-            anchors.margins: -border.width
-            visible: root.selected || root.hovered
-            border.width: 2.5
-            border.color: root.selected ? activePalette.highlight : Qt.darker(activePalette.highlight, 1.5)
-            opacity: 0.9
-            radius: background.radius
-            color: "transparent"
-        }
-
-        Rectangle {
-            id: background
-            anchors.fill: nodeContent
-            color: Qt.lighter(activePalette.base, 1.4)
-            layer.enabled: true
-            layer.effect: DropShadow { radius: 3; color: shadowColor }
-            radius: 3
-            opacity: 0.7
-        }
-
-        Rectangle {
-            id: nodeContent
+        // Detailed representation, only instantiated when the node is visible and zoomed-in enough
+        Loader {
+            id: contentLoader
             width: parent.width
-            height: childrenRect.height
-            color: "transparent"
-
-            // Data Layout
-            Column {
-                id: body
-                width: parent.width
+            active: !root.culled && !root.simplified
+            sourceComponent: Component {
+                Item {
+                    width: contentLoader.width
+                    height: nodeContent.height
+                    onHeightChanged: root.detailedHeight = height
 
-                // Header
-                Rectangle {
-                    id: header
-                    width: parent.width
-                    height: headerLayout.height
-                    color: root.selected ? activePalette.highlight : root.baseColor
-                    radius: background.radius
+                    // Selection border
+                    Rectangle {
+                        anchors.fill: nodeContent
+                        anchors.margins: -border.width
+                        visible: root.selected || root.hovered
+                        border.width: 2.5
+                        border.color: root.selected ? activePalette.highlight : Qt.darker(activePalette.highlight, 1.5)
+                        opacity: 0.9
+                        radius: background.radius
+                        color: "transparent"
+                    }
 
-                    // Fill header's bottom radius
                     Rectangle {
-                        width: parent.width
-                        height: parent.radius
-                        anchors.bottom: parent.bottom
-                        color: parent.color
-                        z: -1
+                        id: background
+                        anchors.fill: nodeContent
+                        color: Qt.lighter(activePalette.base, 1.4)
+                        layer.enabled: true
+                        layer.effect: DropShadow { radius: 3; color: shadowColor }
+                        radius: 3
+                        opacity: 0.7
                     }
 
-                    // Header Layout
-                    RowLayout {
-                        id: headerLayout
+                    Rectangle {
+                        id: nodeContent
                         width: parent.width
-                        spacing: 0
-
-                        // Node Name
-                        Label {
-                            Layout.fillWidth: true
-                            text: node ? node.label : ""
-                            padding: 4
-                            color: root.selected ? "white" : activePalette.text
-                            elide: Text.ElideMiddle
-                            font.pointSize: 8
-                        }
+                        height: childrenRect.height
+                        color: "transparent"
 
-                        // Node State icons
-                        RowLayout {
-                            Layout.fillWidth: true
-                            Layout.alignment: Qt.AlignRight
-                            Layout.rightMargin: 2
-                            spacing: 2
-
-                            // CompatibilityBadge icon for CompatibilityNodes
-                            Loader {
-                                active: root.isCompatibilityNode
-                                sourceComponent: CompatibilityBadge {
-                                    sourceComponent: iconDelegate
-                                    canUpgrade: root.node.canUpgrade
-                                    issueDetails: root.node.issueDetails
-                                }
-                            }
+                        // Data Layout
+                        Column {
+                            id: body
+                            width: parent.width
 
-                            // Data sharing indicator
-                            // Note: for an unknown reason, there are some performance issues with the UI refresh.
-                            // Example: a node duplicated 40 times will be slow while creating another identical node
-                            // (sharing the same uid) will not be as slow. If save, quit and reload, it will become slow.
-                            MaterialToolButton {
-                                property string baseText: "<b>Shares internal folder (data) with other node(s). Hold click for details.</b>"
-                                property string toolTipText: visible ? baseText : ""
-                                visible: node.hasDuplicates
-                                text: MaterialIcons.layers
-                                font.pointSize: 7
-                                padding: 2
-                                palette.text: Colors.sysPalette.text
-                                ToolTip.text: toolTipText
-
-                                onPressed: { offsetReleased.running = false; toolTipText = visible ? generateDuplicateList() : "" }
-                                onReleased: { toolTipText = "" ; offsetReleased.running = true }
-                                onCanceled: released()
-
-                                // Used for a better user experience with the button
-                                // Avoid to change the text too quickly
-                                Timer {
-                                    id: offsetReleased
-                                    interval: 750; running: false; repeat: false
-                                    onTriggered: parent.toolTipText = visible ? parent.baseText : ""
+                            // Header
+                            Rectangle {
+                                id: header
+                                width: parent.width
+                                height: headerLayout.height
+                                color: root.selected ? activePalette.highlight : root.baseColor
+                                radius: background.radius
+
+                                // Fill header's bottom radius
+                                Rectangle {
+                                    width: parent.width
+                                    height: parent.radius
+                                    anchors.bottom: parent.bottom
+                                    color: parent.color
+                                    z: -1
                                 }
-                            }
-
-                            // Submitted externally indicator
-                            MaterialLabel {
-                                visible: ["SUBMITTED", "RUNNING"].includes(node.globalStatus) && node.chunks.count > 0 && node.globalExecMode === "EXTERN"
-                                text: MaterialIcons.cloud
-                                padding: 2
-                                font.pointSize: 7
-                                palette.text: Colors.sysPalette.text
-                                ToolTip.text: "Computed Externally"
-                            }
-
-                            // Lock indicator
-                            MaterialLabel {
-                                visible: root.readOnly
-                                text: MaterialIcons.lock
-                                padding: 2
-                                font.pointSize: 7
-                                palette.text: "red"
-                                ToolTip.text: "Locked"
-                            }
-                        }
-                    }
-                }
 
-                // Node Chunks
-               NodeChunks {
-                   defaultColor: Colors.sysPalette.mid
-                   implicitHeight: 3
-                   width: parent.width
-                   model: node ? node.chunks : undefined
-
-                   Rectangle {
-                       anchors.fill: parent
-                       color: Colors.sysPalette.mid
-                       z: -1
-                   }
-               }
+                                // Header Layout
+                                RowLayout {
+                                    id: headerLayout
+                                    width: parent.width
+                                    spacing: 0
+
+                                    // Node Name
+                                    Label {
+                                        Layout.fillWidth: true
+                                        text: node ? node.label : ""
+                                        padding: 4
+                                        color: root.selected ? "white" : activePalette.text
+                                        elide: Text.ElideMiddle
+                                        font.pointSize: 8
+                                    }
 
-                // Vertical Spacer
-                Item { width: parent.width; height: 2 }
+                                    // Node State icons
+                                    RowLayout {
+                                        Layout.fillWidth: true
+                                        Layout.alignment: Qt.AlignRight
+                                        Layout.rightMargin: 2
+                                        spacing: 2
+
+                                        // CompatibilityBadge icon for CompatibilityNodes
+                                        Loader {
+                                            active: root.isCompatibilityNode
+                                            sourceComponent: CompatibilityBadge {
+                                                sourceComponent: iconDelegate
+                                                canUpgrade: root.node.canUpgrade
+                                                issueDetails: root.node.issueDetails
+                                            }
+                                        }
 
-                // Input/Output Attributes
-                Item {
-                    id: nodeAttributes
-                    width: parent.width - 2
-                    height: childrenRect.height
-                    anchors.horizontalCenter: parent.horizontalCenter
+                                        // Data sharing indicator
+                                        // Note: for an unknown reason, there are some performance issues with the UI refresh.
+                                        // Example: a node duplicated 40 times will be slow while creating another identical node
+                                        // (sharing the same uid) will not be as slow. If save, quit and reload, it will become slow.
+                                        MaterialToolButton {
+                                            property string baseText: "<b>Shares internal folder (data) with other node(s). Hold click for details.</b>"
+                                            property string toolTipText: visible ? baseText : ""
+                                            visible: node.hasDuplicates
+                                            text: MaterialIcons.layers
+                                            font.pointSize: 7
+                                            padding: 2
+                                            palette.text: Colors.sysPalette.text
+                                            ToolTip.text: toolTipText
+
+                                            onPressed: { offsetReleased.running = false; toolTipText = visible ? generateDuplicateList() : "" }
+                                            onReleased: { toolTipText = "" ; offsetReleased.running = true }
+                                            onCanceled: released()
+
+                                            // Used for a better user experience with the button
+                                            // Avoid to change the text too quickly
+                                            Timer {
+                                                id: offsetReleased
+                                                interval: 750; running: false; repeat: false
+                                                onTriggered: parent.toolTipText = visible ? parent.baseText : ""
+                                            }
+                                        }
 
-                    Column {
-                        id: attributesColumn
-                        width: parent.width
-                        spacing: 5
-                        bottomPadding: 2
+                                        // Submitted externally indicator
+                                        MaterialLabel {
+                                            visible: ["SUBMITTED", "RUNNING"].includes(node.globalStatus) && node.chunks.count > 0 && node.globalExecMode === "EXTERN"
+                                            text: MaterialIcons.cloud
+                                            padding: 2
+                                            font.pointSize: 7
+                                            palette.text: Colors.sysPalette.text
+                                            ToolTip.text: "Computed Externally"
+                                        }
 
-                        Column {
-                            id: outputs
-                            width: parent.width
-                            spacing: 3
-                            Repeater {
-                                model: node ? node.attributes : undefined
-
-                                delegate: Loader {
-                                    id: outputLoader
-                                    active: object.isOutput && isFileAttributeBaseType(object)
-                                    anchors.right: parent.right
-                                    width: outputs.width
-
-                                    sourceComponent: AttributePin {
-                                        id: outPin
-                                        nodeItem: root
-                                        attribute: object
-
-                                        property real globalX: root.x + nodeAttributes.x + outputs.x + outputLoader.x + outPin.x
-                                        property real globalY: root.y + nodeAttributes.y + outputs.y + outputLoader.y + outPin.y
-
-                                        onPressed: root.pressed(mouse)
-                                        Component.onCompleted: attributePinCreated(object, outPin)
-                                        Component.onDestruction: attributePinDeleted(attribute, outPin)
+                                        // Lock indicator
+                                        MaterialLabel {
+                                            visible: root.readOnly
+                                            text: MaterialIcons.lock
+                                            padding: 2
+                                            font.pointSize: 7
+                                            palette.text: "red"
+                                            ToolTip.text: "Locked"
+                                        }
                                     }
                                 }
                             }
-                        }
 
-                        Column {
-                            id: inputs
-                            width: parent.width
-                            spacing: 3
-
-                            Repeater {
-                                model: node ? node.attributes : undefined
-                                delegate: Loader {
-                                    id: inputLoader
-                                    active: !object.isOutput && isFileAttributeBaseType(object)
-                                    width: inputs.width
-
-                                    sourceComponent: AttributePin {
-                                        id: inPin
-                                        nodeItem: root
-                                        attribute: object
-
-                                        property real globalX: root.x + nodeAttributes.x + inputs.x + inputLoader.x + inPin.x
-                                        property real globalY: root.y + nodeAttributes.y + inputs.y + inputLoader.y + inPin.y
-
-                                        readOnly: root.readOnly || object.isReadOnly
-                                        Component.onCompleted: attributePinCreated(attribute, inPin)
-                                        Component.onDestruction: attributePinDeleted(attribute, inPin)
-                                        onPressed: root.pressed(mouse)
-                                        onChildPinCreated: attributePinCreated(childAttribute, inPin)
-                                        onChildPinDeleted: attributePinDeleted(childAttribute, inPin)
+                            // Node Chunks
+                           NodeChunks {
+                               defaultColor: Colors.sysPalette.mid
+                               implicitHeight: 3
+                               width: parent.width
+                               model: node ? node.chunks : undefined
+
+                               Rectangle {
+                                   anchors.fill: parent
+                                   color: Colors.sysPalette.mid
+                                   z: -1
+                               }
+                           }
+
+                            // Vertical Spacer
+                            Item { width: parent.width; height: 2 }
+
+                            // Input/Output Attributes
+                            Item {
+                                id: nodeAttributes
+                                width: parent.width - 2
+                                height: childrenRect.height
+                                anchors.horizontalCenter: parent.horizontalCenter
+
+                                Column {
+                                    id: attributesColumn
+                                    width: parent.width
+                                    spacing: 5
+                                    bottomPadding: 2
+
+                                    Column {
+                                        id: outputs
+                                        width: parent.width
+                                        spacing: 3
+                                        Repeater {
+                                            model: node ? node.attributes : undefined
+
+                                            delegate: Loader {
+                                                id: outputLoader
+                                                active: object.isOutput && isFileAttributeBaseType(object)
+                                                anchors.right: parent.right
+                                                width: outputs.width
+
+                                                sourceComponent: AttributePin {
+                                                    id: outPin
+                                                    nodeItem: root
+                                                    attribute: object
+
+                                                    property real globalX: root.x + nodeAttributes.x + outputs.x + outputLoader.x + outPin.x
+                                                    property real globalY: root.y + nodeAttributes.y + outputs.y + outputLoader.y + outPin.y
+
+                                                    onPressed: root.pressed(mouse)
+                                                    Component.onCompleted: attributePinCreated(object, outPin)
+                                                    Component.onDestruction: attributePinDeleted(attribute, outPin)
+                                                }
+                                            }
+                                        }
                                     }
-                                }
-                            }
-                        }
 
-                        // Vertical Spacer
-                        Rectangle {
-                            height: inputParams.height > 0 ? 3 : 0
-                            visible: (height == 3)
-                            Behavior on height { PropertyAnimation {easing.type: Easing.Linear} }
-                            width: parent.width
-                            color: Colors.sysPalette.mid
-                            MaterialToolButton {
-                                text: " "
-                                width: parent.width
-                                height: parent.height
-                                padding: 0
-                                spacing: 0
-                                anchors.margins: 0
-                                font.pointSize: 6
-                                onClicked: {
-                                    m.displayParams = ! m.displayParams
-                                }
-                            }
-                        }
+                                    Column {
+                                        id: inputs
+                                        width: parent.width
+                                        spacing: 3
+
+                                        Repeater {
+                                            model: node ? node.attributes : undefined
+                                            delegate: Loader {
+                                                id: inputLoader
+                                                active: !object.isOutput && isFileAttributeBaseType(object)
+                                                width: inputs.width
+
+                                                sourceComponent: AttributePin {
+                                                    id: inPin
+                                                    nodeItem: root
+                                                    attribute: object
+
+                                                    property real globalX: root.x + nodeAttributes.x + inputs.x + inputLoader.x + inPin.x
+                                                    property real globalY: root.y + nodeAttributes.y + inputs.y + inputLoader.y + inPin.y
+
+                                                    readOnly: root.readOnly || object.isReadOnly
+                                                    Component.onCompleted: attributePinCreated(attribute, inPin)
+                                                    Component.onDestruction: attributePinDeleted(attribute, inPin)
+                                                    onPressed: root.pressed(mouse)
+                                                    onChildPinCreated: attributePinCreated(childAttribute, inPin)
+                                                    onChildPinDeleted: attributePinDeleted(childAttribute, inPin)
+                                                }
+                                            }
+                                        }
+                                    }
 
-                        Rectangle {
-                            id: inputParamsRect
-                            width: parent.width
-                            height: childrenRect.height
-                            color: "transparent"
+                                    // Vertical Spacer
+                                    Rectangle {
+                                        height: inputParams.height > 0 ? 3 : 0
+                                        visible: (height == 3)
+                                        Behavior on height { PropertyAnimation {easing.type: Easing.Linear} }
+                                        width: parent.width
+                                        color: Colors.sysPalette.mid
+                                        MaterialToolButton {
+                                            text: " "
+                                            width: parent.width
+                                            height: parent.height
+                                            padding: 0
+                                            spacing: 0
+                                            anchors.margins: 0
+                                            font.pointSize: 6
+                                            onClicked: {
+                                                m.displayParams = ! m.displayParams
+                                            }
+                                        }
+                                    }
 
-                            Column {
-                                id: inputParams
-                                width: parent.width
-                                spacing: 3
-                                Repeater {
-                                    id: inputParamsRepeater
-                                    model: node ? node.attributes : undefined
-                                    delegate: Loader {
-                                        id: paramLoader
-                                        active: !object.isOutput && !isFileAttributeBaseType(object)
-                                        property bool isFullyActive: (m.displayParams || object.isLink || object.hasOutputConnections)
+                                    Rectangle {
+                                        id: inputParamsRect
                                         width: parent.width
+                                        height: childrenRect.height
+                                        color: "transparent"
+
+                                        Column {
+                                            id: inputParams
+                                            width: parent.width
+                                            spacing: 3
+                                            Repeater {
+                                                id: inputParamsRepeater
+                                                model: node ? node.attributes : undefined
+                                                delegate: Loader {
+                                                    id: paramLoader
+                                                    active: !object.isOutput && !isFileAttributeBaseType(object)
+                                                    property bool isFullyActive: (m.displayParams || object.isLink || object.hasOutputConnections)
+                                                    width: parent.width
+
+                                                    sourceComponent: AttributePin {
+                                                        id: inPin
+                                                        nodeItem: root
+                                                        property real globalX: root.x + nodeAttributes.x + inputParamsRect.x + paramLoader.x + inPin.x
+                                                        property real globalY: root.y + nodeAttributes.y + inputParamsRect.y + paramLoader.y + inPin.y
+
+                                                        height: isFullyActive ? childrenRect.height : 0
+                                                        Behavior on height { PropertyAnimation {easing.type: Easing.Linear} }
+                                                        visible: (height == childrenRect.height)
+                                                        attribute: object
+                                                        readOnly: root.readOnly || object.isReadOnly
+                                                        Component.onCompleted: attributePinCreated(attribute, inPin)
+                                                        Component.onDestruction: attributePinDeleted(attribute, inPin)
+                                                        onPressed: root.pressed(mouse)
+                                                        onChildPinCreated: attributePinCreated(childAttribute, inPin)
+                                                        onChildPinDeleted: attributePinDeleted(childAttribute, inPin)
+                                                    }
+                                                }
+                                            }
+                                        }
+                                    }
 
-                                        sourceComponent: AttributePin {
-                                            id: inPin
-                                            nodeItem: root
-                                            property real globalX: root.x + nodeAttributes.x + inputParamsRect.x + paramLoader.x + inPin.x
-                                            property real globalY: root.y + nodeAttributes.y + inputParamsRect.y + paramLoader.y + inPin.y
-
-                                            height: isFullyActive ? childrenRect.height : 0
-                                            Behavior on height { PropertyAnimation {easing.type: Easing.Linear} }
-                                            visible: (height == childrenRect.height)
-                                            attribute: object
-                                            readOnly: root.readOnly || object.isReadOnly
-                                            Component.onCompleted: attributePinCreated(attribute, inPin)
-                                            Component.onDestruction: attributePinDeleted(attribute, inPin)
-                                            onPressed: root.pressed(mouse)
-                                            onChildPinCreated: attributePinCreated(childAttribute, inPin)
-                                            onChildPinDeleted: attributePinDeleted(childAttribute, inPin)
+                                    MaterialToolButton {
+                                        text: root.hovered ? (m.displayParams ? MaterialIcons.arrow_drop_up : MaterialIcons.arrow_drop_down) : " "
+                                        Layout.alignment: Qt.AlignBottom
+                                        width: parent.width
+                                        height: 5
+                                        padding: 0
+                                        spacing: 0
+                                        anchors.margins: 0
+                                        font.pointSize: 10
+                                        onClicked: {
+                                            m.displayParams = ! m.displayParams
                                         }
                                     }
                                 }
                             }
                         }
+                    }
+                }
+            }
+        }
 
-                        MaterialToolButton {
-                            text: root.hovered ? (m.displayParams ? MaterialIcons.arrow_drop_up : MaterialIcons.arrow_drop_down) : " "
-                            Layout.alignment: Qt.AlignBottom
-                            width: parent.width
-                            height: 5
-                            padding: 0
-                            spacing: 0
-                            anchors.margins: 0
-                            font.pointSize: 10
-                            onClicked: {
-                                m.displayParams = ! m.displayParams
-                            }
-                        }
+        // Simplified representation
+        Loader {
+            width: parent.width
+            active: !root.culled && root.simplified
+            sourceComponent: Component {
+                Rectangle {
+                    height: root.simplifiedHeight
+                    color: root.selected ? activePalette.highlight : root.baseColor
+                    border.width: root.hovered ? 2 : 0
+                    border.color: Qt.darker(activePalette.highlight, 1.5)
+                    radius: 3
+
+                    Label {
+                        anchors.fill: parent
+                        text: node ? node.label : ""
+                        padding: 4
+                        color: root.selected ? "white" : activePalette.text
+                        elide: Text.ElideMiddle
+                        verticalAlignment: Text.AlignVCenter
+                        font.pointSize: 8
                     }
                 }
             }
@@ -3,6 +3,7 @@ import QtQuick.Controls 2.3
 import QtQuick.Layouts 1.3
 import MaterialIcons 2.2
 import Controls 1.0
+import Utils 1.0
 
 import "common.js" as Common
 
@@ -23,10 +24,42 @@ FocusScope {
 
     SystemPalette { id: activePalette }
 
+    // Live progress of the current chunk, read from its progress channel
+    RowLayout {
+        id: progressRow
+        property bool running: root.currentChunk !== undefined && root.currentChunk.statusName === "RUNNING"
+        visible: running && root.currentChunk.progress >= 0
+        anchors.left: parent.left
+        anchors.right: parent.right
+        anchors.margins: 4
+        height: visible ? implicitHeight : 0
+
+        Label {
+            text: visible ? root.currentChunk.progressLabel : ""
+            visible: text !== ""
+            elide: Text.ElideRight
+        }
+        ProgressBar {
+            Layout.fillWidth: true
+            from: 0
+            to: 1
+            value: progressRow.visible ? root.currentChunk.progress : 0
+        }
+        Label {
+            text: progressRow.visible ? Math.round(root.currentChunk.progress * 100) + "%" : ""
+        }
+        Label {
+            text: progressRow.visible && root.currentChunk.eta >= 0 ? "ETA " + Format.sec2time(root.currentChunk.eta) : ""
+        }
+    }
+
     Loader {
         id: componentLoader
         clip: true
-        anchors.fill: parent
+        anchors.top: progressRow.bottom
+        anchors.left: parent.left
+        anchors.right: parent.right
+        anchors.bottom: parent.bottom
 
         property string currentFile: (root.currentChunkIndex >= 0 && root.currentChunk) ? root.currentChunk["logFile"] : ""
         property url source: Filepath.stringToUrl(currentFile)
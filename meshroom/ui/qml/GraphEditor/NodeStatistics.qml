@@ -29,6 +29,7 @@ FocusScope {
         anchors.fill: parent
         property string currentFile: currentChunk ? currentChunk["statisticsFile"] : ""
         property url source: Filepath.stringToUrl(currentFile)
+        property url previousSource: Filepath.stringToUrl(currentChunk ? currentChunk["previousStatisticsFile"] : "")
 
         sourceComponent: chunksLV.chunksSummary ? statViewerComponent : chunkStatViewerComponent
     }
@@ -39,6 +40,7 @@ FocusScope {
             id: statViewer
             anchors.fill: parent
             source: componentLoader.source
+            previousSource: componentLoader.previousSource
         }
     }
 
@@ -5,6 +5,7 @@ import QtQuick.Layouts 1.11
 import Utils 1.0
 import Charts 1.0
 import MaterialIcons 2.2
+import DataObjects 1.0
 
 
 Item {
@@ -16,22 +17,25 @@ Item {
     /// Statistics source file
     property url source
 
-    property var sourceModified: undefined
-    property var jsonObject
-    property real fileVersion: 0.0
+    /// Statistics file of the previous computation
+    property url previousSource
+    /// Whether to display the statistics of the previous computation
+    property bool comparePrevious: false
 
-    property int nbReads: 1
-    property real deltaTime: 1
+    readonly property real fileVersion: statistics.fileVersion
 
-    property int nbCores: 0
-    property int cpuFrequency: 0
+    readonly property int nbReads: Math.max(statistics.nbReads, comparePrevious ? previousStatistics.nbReads : 0)
+    readonly property real deltaTime: statistics.deltaTime
 
-    property int ramTotal
-    property string ramLabel: "RAM: "
+    readonly property int nbCores: statistics.nbCores
+    readonly property int cpuFrequency: statistics.cpuFrequency
 
-    property int gpuTotalMemory
-    property int gpuMaxAxis: 100
-    property string gpuName
+    readonly property int ramTotal: statistics.ramTotal
+    readonly property string ramLabel: statistics.ramMaxPeak ? "RAM Max Peak: " : "RAM: "
+
+    readonly property int gpuTotalMemory: statistics.gpuTotalMemory
+    readonly property int gpuMaxAxis: Math.max(statistics.gpuMaxValue, comparePrevious ? previousStatistics.gpuMaxValue : 0)
+    readonly property string gpuName: statistics.gpuName
 
     property color textColor: Colors.sysPalette.text
 
@@ -71,59 +75,28 @@ Item {
         "#BF360C"
     ]
 
-    onSourceChanged: {
-        sourceModified = undefined;
-        resetCharts()
-        readSourceFile()
+    // Statistics are read from Python, series are only created when the set of curves changes
+    // and the model then appends new samples to them
+    StatisticsModel {
+        id: statistics
+        // make sure we are trying to load a statistics file
+        source: Filepath.urlToString(root.source).endsWith("statistics") ? root.source : ""
+        onCurvesChanged: createCharts()
     }
 
-    function getPropertyWithDefault(prop, name, defaultValue) {
-        if(prop.hasOwnProperty(name)) {
-            return prop[name];
-        }
-        return defaultValue;
+    StatisticsModel {
+        id: previousStatistics
+        source: root.comparePrevious ? root.previousSource : ""
+        onCurvesChanged: createCharts()
     }
 
     Timer {
         id: reloadTimer
-        interval: root.deltaTime * 60000; running: true; repeat: false
-        onTriggered: readSourceFile()
-
-    }
-
-    function readSourceFile() {
-        // make sure we are trying to load a statistics file
-        if(!Filepath.urlToString(source).endsWith("statistics"))
-            return;
-
-        var xhr = new XMLHttpRequest;
-        xhr.open("GET", source);
-
-        xhr.onreadystatechange = function() {
-            if (xhr.readyState === XMLHttpRequest.DONE && xhr.status == 200) {
-
-                if(sourceModified === undefined || sourceModified < xhr.getResponseHeader('Last-Modified')) {
-                    try {
-                        root.jsonObject = JSON.parse(xhr.responseText);
-                    }
-                    catch(exc)
-                    {
-                        console.warning("Failed to parse statistics file: " + source)
-                        root.jsonObject = {};
-                        return;
-                    }
-                    resetCharts();
-                    sourceModified = xhr.getResponseHeader('Last-Modified')
-                    root.createCharts();
-                    reloadTimer.restart();
-                }
-            }
-        };
-        xhr.send();
+        interval: root.deltaTime * 60000; running: root.visible; repeat: true
+        onTriggered: statistics.update()
     }
 
     function resetCharts() {
-        root.fileVersion = 0.0
         cpuLegend.clear()
         cpuChart.removeAllSeries()
         ramChart.removeAllSeries()
@@ -131,11 +104,19 @@ Item {
     }
 
     function createCharts() {
-        root.deltaTime = getPropertyWithDefault(jsonObject, 'interval', 30) / 60.0;
-        root.fileVersion = getPropertyWithDefault(jsonObject, 'fileVersion', 0.0)
+        resetCharts()
         initCpuChart()
         initRamChart()
         initGpuChart()
+        if(root.comparePrevious)
+            initPreviousCharts()
+    }
+
+    function createSeries(chart, name, curve, color, axisX, axisY, model) {
+        var lineSerie = chart.createSeries(ChartView.SeriesTypeLine, name, axisX, axisY)
+        lineSerie.color = color
+        model.registerSeries(curve, lineSerie)
+        return lineSerie
     }
 
 
@@ -144,59 +125,10 @@ Item {
 **************************/
 
     function initCpuChart() {
-
-        var categories = []
-        var categoryCount = 0
-        var category
-        do {
-            category = jsonObject.computer.curves["cpuUsage." + categoryCount]
-            if(category !== undefined) {
-                categories.push(category)
-                categoryCount++
-            }
-        } while(category !== undefined)
-
-        var nbCores = categories.length
-        root.nbCores = nbCores
-
-        root.cpuFrequency = getPropertyWithDefault(jsonObject.computer, 'cpuFreq', -1)
-
-        root.nbReads = categories[0].length-1
-
-        for(var j = 0; j < nbCores; j++) {
-            var lineSerie = cpuChart.createSeries(ChartView.SeriesTypeLine, "CPU" + j, valueCpuX, valueCpuY)
-
-            if(categories[j].length === 1) {
-                lineSerie.append(0, categories[j][0])
-                lineSerie.append(root.deltaTime, categories[j][0])
-            } else {
-                for(var k = 0; k < categories[j].length; k++) {
-                    lineSerie.append(k * root.deltaTime, categories[j][k])
-                }
-            }
-            lineSerie.color = colors[j % colors.length]
-        }
-
-        var averageLine = cpuChart.createSeries(ChartView.SeriesTypeLine, "AVERAGE", valueCpuX, valueCpuY)
-        var average = []
-
-        for(var l = 0; l < categories[0].length; l++) {
-            average.push(0)
+        for(var j = 0; j < statistics.nbCores; j++) {
+            createSeries(cpuChart, "CPU" + j, "cpuUsage." + j, colors[j % colors.length], valueCpuX, valueCpuY, statistics)
         }
-
-        for(var m = 0; m < categories.length; m++) {
-            for(var n = 0; n < categories[m].length; n++) {
-                average[n] += categories[m][n]
-            }
-        }
-
-        for(var q = 0; q < average.length; q++) {
-            average[q] = average[q] / (categories.length)
-
-            averageLine.append(q * root.deltaTime, average[q])
-        }
-
-        averageLine.color = colors[colors.length-1]
+        createSeries(cpuChart, "AVERAGE", "cpuAverage", colors[colors.length-1], valueCpuX, valueCpuY, statistics)
     }
 
     function hideOtherCpu(index) {
@@ -212,33 +144,7 @@ Item {
 **************************/
 
     function initRamChart() {
-
-        var ram = getPropertyWithDefault(jsonObject.computer.curves, 'ramUsage', -1)
-
-        root.ramTotal = getPropertyWithDefault(jsonObject.computer, 'ramTotal', -1)
-        root.ramLabel = "RAM: "
-        if(root.ramTotal <= 0)
-        {
-            var maxRamPeak = 0
-            for(var i = 0; i < ram.length; i++) {
-                maxRamPeak = Math.max(maxRamPeak, ram[i])
-            }
-            root.ramTotal = maxRamPeak
-            root.ramLabel = "RAM Max Peak: "
-        }
-
-        var ramSerie = ramChart.createSeries(ChartView.SeriesTypeLine, root.ramLabel + root.ramTotal + "GB", valueRamX, valueRamY)
-
-        if(ram.length === 1) {
-            // Create 2 entries if we have only one input value to create a segment that can be display
-            ramSerie.append(0, ram[0])
-            ramSerie.append(root.deltaTime, ram[0])
-        } else {
-            for(var i = 0; i < ram.length; i++) {
-                ramSerie.append(i * root.deltaTime, ram[i])
-            }
-        }
-        ramSerie.color = colors[10]
+        createSeries(ramChart, root.ramLabel + root.ramTotal + "GB", "ramUsage", colors[10], valueRamX, valueRamY, statistics)
     }
 
 /**************************
@@ -246,39 +152,23 @@ Item {
 **************************/
 
     function initGpuChart() {
-        root.gpuTotalMemory = getPropertyWithDefault(jsonObject.computer, 'gpuMemoryTotal', 0)
-        root.gpuName = getPropertyWithDefault(jsonObject.computer, 'gpuName', '')
-
-        var gpuUsedMemory = getPropertyWithDefault(jsonObject.computer.curves, 'gpuMemoryUsed', 0)
-        var gpuUsed = getPropertyWithDefault(jsonObject.computer.curves, 'gpuUsed', 0)
-        var gpuTemperature = getPropertyWithDefault(jsonObject.computer.curves, 'gpuTemperature', 0)
-
-        var gpuUsedSerie = gpuChart.createSeries(ChartView.SeriesTypeLine, "GPU", valueGpuX, valueGpuY)
-        var gpuUsedMemorySerie = gpuChart.createSeries(ChartView.SeriesTypeLine, "Memory", valueGpuX, valueGpuY)
-        var gpuTemperatureSerie = gpuChart.createSeries(ChartView.SeriesTypeLine, "Temperature", valueGpuX, valueGpuY)
-
-        var gpuMemoryRatio = root.gpuTotalMemory > 0 ? (100 / root.gpuTotalMemory) : 1;
-
-        if(gpuUsedMemory.length === 1) {
-            gpuUsedSerie.append(0, gpuUsed[0])
-            gpuUsedSerie.append(1 * root.deltaTime, gpuUsed[0])
-
-            gpuUsedMemorySerie.append(0, gpuUsedMemory[0] * gpuMemoryRatio)
-            gpuUsedMemorySerie.append(1 * root.deltaTime, gpuUsedMemory[0] * gpuMemoryRatio)
-
-            gpuTemperatureSerie.append(0, gpuTemperature[0])
-            gpuTemperatureSerie.append(1 * root.deltaTime, gpuTemperature[0])
-            root.gpuMaxAxis = Math.max(gpuMaxAxis, gpuTemperature[0])
-        } else {
-            for(var i = 0; i < gpuUsedMemory.length; i++) {
-                gpuUsedSerie.append(i * root.deltaTime, gpuUsed[i])
+        createSeries(gpuChart, "GPU", "gpuUsed", colors[5], valueGpuX, valueGpuY, statistics)
+        createSeries(gpuChart, "Memory", "gpuMemoryUsed", colors[9], valueGpuX, valueGpuY, statistics)
+        createSeries(gpuChart, "Temperature", "gpuTemperature", colors[14], valueGpuX, valueGpuY, statistics)
+    }
 
-                gpuUsedMemorySerie.append(i * root.deltaTime, gpuUsedMemory[i] * gpuMemoryRatio)
+/**************************
+***      PREVIOUS       ***
+**************************/
 
-                gpuTemperatureSerie.append(i * root.deltaTime, gpuTemperature[i])
-                root.gpuMaxAxis = Math.max(gpuMaxAxis, gpuTemperature[i])
-            }
-        }
+    function initPreviousCharts() {
+        var series = [
+            createSeries(cpuChart, "PREVIOUS AVERAGE", "cpuAverage", colors[colors.length-1], valueCpuX, valueCpuY, previousStatistics),
+            createSeries(ramChart, "Previous RAM", "ramUsage", colors[10], valueRamX, valueRamY, previousStatistics),
+            createSeries(gpuChart, "Previous GPU", "gpuUsed", colors[5], valueGpuX, valueGpuY, previousStatistics)
+        ]
+        for(var i = 0; i < series.length; ++i)
+            series[i].style = Qt.DashLine
     }
 
 
@@ -364,6 +254,14 @@ Item {
                             chartView: cpuChart
                         }
 
+                        ChartViewCheckBox {
+                            text: "PREVIOUS RUN"
+                            color: textColor
+                            enabled: root.previousSource != ""
+                            checked: root.comparePrevious
+                            onClicked: root.comparePrevious = checked
+                        }
+
                     }
                 }
 
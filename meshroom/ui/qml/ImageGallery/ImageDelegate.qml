@@ -28,7 +28,7 @@ Item {
         property url source: viewpoint ? Filepath.stringToUrl(viewpoint.get("path").value) : ''
         property int viewId: viewpoint ? viewpoint.get("viewId").value : -1
         property string metadataStr: viewpoint ? viewpoint.get("metadata").value : ''
-        property var metadata: metadataStr ? JSON.parse(viewpoint.get("metadata").value) : {}
+        property var metadata: metadataStr ? _reconstruction.parseViewpointMetadata(metadataStr) : {}
     }
 
     MouseArea {
@@ -76,13 +76,12 @@ Item {
                 Layout.fillWidth: true
                 border.color: isCurrentItem ? imageLabel.palette.highlight : Qt.darker(imageLabel.palette.highlight)
                 border.width: imageMA.containsMouse || root.isCurrentItem ? 2 : 0
+                // downscaled preview from the thumbnail cache
                 Image {
                     anchors.fill: parent
                     anchors.margins: 4
-                    source: root.source
-                    sourceSize: Qt.size(100, 100)
+                    source: Thumbnails.source(root.source)
                     asynchronous: true
-                    autoTransform: true
                     fillMode: Image.PreserveAspectFit
                 }
             }
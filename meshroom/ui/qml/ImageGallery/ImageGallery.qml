@@ -31,6 +31,9 @@ Panel {
 
     title: "Images"
     implicitWidth: (root.defaultCellSize + 2) * 2
+    // reconstruction status of the images, read from the SfM results
+    loading: _reconstruction ? _reconstruction.sfmReportLoading : false
+    loadingText: loading ? "Loading SfM" : ""
 
     function changeCurrentIndex(newIndex) {
         _reconstruction.cameraInitIndex = newIndex
@@ -100,6 +103,40 @@ Panel {
             highlightFollowsCurrentItem: true
             keyNavigationEnabled: true
 
+            // number of rows before and after the visible ones whose thumbnails are prefetched
+            property int prefetchRows: 3
+
+            onContentYChanged: prefetchTimer.restart()
+            onCountChanged: prefetchTimer.restart()
+            onWidthChanged: prefetchTimer.restart()
+            onHeightChanged: prefetchTimer.restart()
+            onCellWidthChanged: prefetchTimer.restart()
+
+            // wait for scrolling to settle before prefetching
+            Timer {
+                id: prefetchTimer
+                interval: 100
+                onTriggered: grid.prefetchThumbnails()
+            }
+
+            function prefetchThumbnails() {
+                if(count === 0)
+                    return
+                var columns = Math.max(1, Math.floor(width / cellWidth))
+                var firstRow = Math.floor((contentY - originY) / cellHeight)
+                var lastRow = firstRow + Math.ceil(height / cellHeight)
+                var first = Math.max(0, (firstRow - prefetchRows) * columns)
+                var last = Math.min(count, (lastRow + prefetchRows + 1) * columns)
+                var paths = []
+                for(var i = first; i < last; ++i)
+                {
+                    var item = sortedModel.filteredItem(i)
+                    if(item.model.object)
+                        paths.push(item.model.object.childAttribute("path").value)
+                }
+                Thumbnails.prefetch(paths)
+            }
+
             // Update grid current item when selected view changes
             Connections {
                 target: _reconstruction
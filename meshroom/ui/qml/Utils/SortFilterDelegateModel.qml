@@ -65,6 +65,11 @@ DelegateModel {
         return item.model[roleName]
     }
 
+    /// Get the item at 'index' in the filtered (displayed) items
+    function filteredItem(index) {
+        return filteredItems.get(index)
+    }
+
     /// Get the index of the first element which matches 'value' for the given 'roleName'
     function find(value, roleName) {
         for(var i = 0; i < filteredItems.count; ++i)
@@ -16,6 +16,8 @@ FloatingPane {
 
     property var ldrHdrCalibrationNode: null
     property color textColor: Colors.sysPalette.text
+    // curves are downsampled to this number of points for display
+    property int maxCurvePoints: 1000
 
     clip: true
     padding: 4
@@ -24,6 +26,7 @@ FloatingPane {
         id: csvData
         property bool hasAttr: (ldrHdrCalibrationNode && ldrHdrCalibrationNode.hasAttribute("response"))
         filepath: hasAttr ? ldrHdrCalibrationNode.attribute("response").value : ""
+        maxPoints: root.maxCurvePoints
     }
 
     // To avoid interaction with components in background
@@ -4,6 +4,13 @@ import Qt3D.Render 2.1
 
 import Utils 1.0
 
+/**
+ * MediaCache keeps unloaded 3D media entities in memory to instantly reload them.
+ *
+ * Entities are evicted in least recently used order when their estimated memory size
+ * exceeds the memory budget. Entities that have been reloaded from the cache several times
+ * (e.g. dense point clouds frequently toggled) are only evicted after the other ones.
+ */
 Entity {
     id: root
 
@@ -36,70 +43,106 @@ Entity {
         ]
     }
 
-    property int cacheSize: 2
-    property var mediaCache: {[]}
+    /// Memory budget (in bytes) of the cached entities
+    property real memoryBudget: 2 * 1024 * 1024 * 1024
+    /// Estimated memory size of a texture (in bytes)
+    property real textureSize: 2048 * 2048 * 4
+    /// Number of reloads from the cache after which an entity is kept resident in priority
+    property int residentHits: 2
+    /// The current estimated memory size of the cached entities
+    readonly property alias memorySize: m.memorySize
+
+    QtObject {
+        id: m
+        // source -> {"object", "size"}
+        property var entries: ({})
+        // cached sources, from least to most recently used
+        property var order: []
+        // source -> number of reloads from the cache (kept when the entity is evicted)
+        property var hits: ({})
+        property real memorySize: 0
+    }
 
     /// The current number of managed entities
     function currentSize() {
-        return Object.keys(mediaCache).length;
+        return m.order.length;
     }
 
     /// Whether the cache contains an entity for the given source
     function contains(source) {
-        return mediaCache[source] !== undefined;
+        return m.entries[source] !== undefined;
+    }
+
+    /// Estimated memory size of an entity (in bytes)
+    function entitySize(object) {
+        var size = Scene3DHelper.geometrySize(object);
+        if(object.textureCount)
+            size += object.textureCount * textureSize;
+        return size;
     }
 
     /// Add an entity to the cache
     function add(source, object){
-        if(!Filepath.exists(source))
-            return false;
         if(contains(source))
             return true;
-        if(debug) { console.log("[cache] add: " + source); }
-        mediaCache[source] = object;
+        var size = entitySize(object);
+        if(size > memoryBudget)
+            return false;
+        if(debug) { console.log("[cache] add: " + source + " (" + Math.round(size / (1024 * 1024)) + "MB)"); }
+        m.entries[source] = { "object": object, "size": size };
+        m.order.push(source);
+        m.memorySize += size;
         object.parent = root;
-        // remove oldest entry in cache
-        if(currentSize() > cacheSize)
-            shrink();
+        shrink();
         return true;
     }
 
+    /// Remove an entity from the cache and return it
+    function take(source) {
+        var entry = m.entries[source];
+        delete m.entries[source];
+        m.order.splice(m.order.indexOf(source), 1);
+        m.memorySize -= entry.size;
+        return entry.object;
+    }
+
     /// Pop an entity from the cache based on its source
     function pop(source){
         if(!contains(source))
             return undefined;
-
-        var obj = mediaCache[source];
-        delete mediaCache[source];
         if(debug) { console.log("[cache] pop: " + source); }
-        // delete cached obj if file does not exist on disk anymore
-        if(!Filepath.exists(source))
-        {
-            if(debug){ console.log("[cache] destroy: " + source); }
-            obj.destroy();
-            obj = undefined;
-        }
-        return obj;
+        m.hits[source] = (m.hits[source] || 0) + 1;
+        return take(source);
     }
 
     /// Remove and destroy an entity from cache
     function destroyEntity(source) {
-        var obj = pop(source);
-        if(obj)
-            obj.destroy();
+        if(!contains(source))
+            return;
+        if(debug){ console.log("[cache] destroy: " + source); }
+        take(source).destroy();
     }
 
-
-    // Shrink cache to fit max size
+    /// Shrink cache to fit the memory budget
     function shrink() {
-        while(currentSize() > cacheSize)
-            destroyEntity(Object.keys(mediaCache)[0]);
+        while(m.memorySize > memoryBudget && m.order.length > 0) {
+            // least recently used entity, not resident if possible
+            var source = m.order[0];
+            for(var i = 0; i < m.order.length; ++i) {
+                if((m.hits[m.order[i]] || 0) < residentHits) {
+                    source = m.order[i];
+                    break;
+                }
+            }
+            destroyEntity(source);
+        }
     }
 
-    // Clear cache and destroy all managed entities
+    /// Clear cache and destroy all managed entities
     function clear() {
-        Object.keys(mediaCache).forEach(function(key){
+        m.order.slice().forEach(function(key){
             destroyEntity(key);
         });
+        m.hits = {};
     }
 }
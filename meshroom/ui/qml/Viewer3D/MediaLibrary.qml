@@ -146,7 +146,7 @@ Entity {
         cache.clear();
     }
 
-    // Cache that keeps in memory the last unloaded 3D media
+    // Cache that keeps in memory the recently unloaded 3D media, within a memory budget
     MediaCache {
         id: cache
     }
@@ -255,9 +255,10 @@ Entity {
                 function updateCacheAndModel(forceRequest) {
                     // don't cache explicitly unloaded media
                     if(model.requested && object && dependencyReady) {
-                        // cache current object
-                        if(cache.add(Filepath.urlToString(mediaLoader.source), object));
-                            object = null;
+                        // cache current object, or release it if it does not fit in the cache
+                        if(!cache.add(Filepath.urlToString(mediaLoader.source), object))
+                            object.destroy();
+                        object = null;
                     }
                     updateModel(forceRequest);
                 }
@@ -282,6 +283,12 @@ Entity {
                         remove(index)
                 }
 
+                // cached entity is outdated when the media is being recomputed
+                onDependencyReadyChanged: {
+                    if(!dependencyReady)
+                        cache.destroyEntity(rawSource);
+                }
+
                 onCurrentSourceChanged: {
                     updateCacheAndModel(false)
 
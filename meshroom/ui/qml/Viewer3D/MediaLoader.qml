@@ -64,18 +64,90 @@ import Utils 1.0
             id: sceneLoaderEntity
             objectName: "SceneLoader"
 
-            components: [
-                SceneLoader {
-                    source: parent.source
-                    onStatusChanged: {
-                        if(status == SceneLoader.Ready) {
-                            textureCount = sceneLoaderPostProcess(sceneLoaderEntity);
-                            faceCount = Scene3DHelper.faceCount(sceneLoaderEntity)
+            // sources loaded successively, from coarsest to finest:
+            // levels of detail of large media (see MeshLod), then the media itself
+            property var levelSources: []
+            // index in levelSources of the displayed level
+            property int levelIndex: -1
+            // entity of the displayed level
+            property Entity currentLevel: null
+            // entity of the level being loaded
+            property Entity pendingLevel: null
+
+            Component.onCompleted: {
+                // missing levels are built in the background while the whole media is loaded
+                if(!MeshLod.isSupported(source) || MeshLod.build(source)) {
+                    levelSources = [source];
+                    loadLevel(0);
+                    return;
+                }
+                loadLevels();
+            }
+
+            // switch to the levels once built if the whole media is not displayed yet
+            Connections {
+                target: MeshLod
+                onLevelsReady: {
+                    if(mediaSource.toString() !== sceneLoaderEntity.source.toString() || sceneLoaderEntity.currentLevel)
+                        return;
+                    // the build may have failed: keep loading the whole media
+                    if(MeshLod.levels(mediaSource).length > 0)
+                        sceneLoaderEntity.loadLevels();
+                }
+            }
+
+            function loadLevels() {
+                var levels = MeshLod.levels(source);
+                if(Viewer3DSettings.lodFullResolution || levels.length === 0)
+                    levels.push(source);
+                levelSources = levels;
+                loadLevel(0);
+            }
+
+            function loadLevel(index) {
+                if(pendingLevel)
+                    pendingLevel.destroy();
+                pendingLevel = levelComponent.createObject(sceneLoaderEntity, {"levelIndex": index, "source": levelSources[index]});
+            }
+
+            Component {
+                id: levelComponent
+                Entity {
+                    id: levelEntity
+                    property int levelIndex
+                    property url source
+
+                    components: [
+                        SceneLoader {
+                            source: levelEntity.source
+                            onStatusChanged: {
+                                if(status == SceneLoader.Ready) {
+                                    sceneLoaderEntity.textureCount = sceneLoaderPostProcess(levelEntity);
+                                    sceneLoaderEntity.faceCount = Scene3DHelper.faceCount(levelEntity);
+                                    // replace the coarser level
+                                    if(sceneLoaderEntity.currentLevel)
+                                        sceneLoaderEntity.currentLevel.destroy();
+                                    sceneLoaderEntity.currentLevel = levelEntity;
+                                    sceneLoaderEntity.pendingLevel = null;
+                                    sceneLoaderEntity.levelIndex = levelEntity.levelIndex;
+                                    if(levelEntity.levelIndex + 1 < sceneLoaderEntity.levelSources.length)
+                                        sceneLoaderEntity.loadLevel(levelEntity.levelIndex + 1);
+                                }
+                                else if(status == SceneLoader.Error && sceneLoaderEntity.currentLevel) {
+                                    // keep displaying the coarser level
+                                    console.warn("Viewer3D: Failed to load " + levelEntity.source);
+                                    sceneLoaderEntity.pendingLevel = null;
+                                    levelEntity.destroy();
+                                    return;
+                                }
+                                // a level is displayed once loaded: refining it does not change the status
+                                if(!sceneLoaderEntity.currentLevel || status == SceneLoader.Ready)
+                                    root.status = status;
+                            }
                         }
-                        root.status = status;
-                    }
+                    ]
                 }
-            ]
+            }
         }
     }
 
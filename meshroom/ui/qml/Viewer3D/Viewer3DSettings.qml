@@ -36,6 +36,10 @@ Item {
     // Whether to display normals
     property bool displayNormals: false
 
+    // Whether large media displayed progressively are refined up to the media itself,
+    // otherwise up to their finest level of detail
+    property bool lodFullResolution: true
+
     // Rasterized point size
     property real pointSize: 1.5
     // Whether point size is fixed or view dependent
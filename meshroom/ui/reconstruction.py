@@ -14,6 +14,8 @@ from meshroom import multiview
 from meshroom.common.qt import QObjectListModel
 from meshroom.core import Version
 from meshroom.core.node import Node, CompatibilityNode, Status, Position
+from meshroom.core.sfmData import SfMDataCache
+from meshroom.core.viewpointMetadata import parseMetadata
 from meshroom.ui.graph import UIGraph
 from meshroom.ui.utils import makeProperty
 
@@ -217,13 +219,8 @@ class ViewpointWrapper(QObject):
             self._metadata = {}
         else:
             self._initialIntrinsics = self._reconstruction.getIntrinsic(self._viewpoint)
-            try:
-                self._metadata = json.loads(self._viewpoint.metadata.value) if self._viewpoint.metadata.value else None
-            except Exception as e:
-                logging.warning("Failed to parse Viewpoint metadata: '{}', '{}'".format(str(e), str(self._viewpoint.metadata.value)))
-                self._metadata = {}
-            if not self._metadata:
-                self._metadata = {}
+            metadata = parseMetadata(self._viewpoint.metadata.value)
+            self._metadata = metadata.data if metadata else {}
         self.initialParamsChanged.emit()
 
     def _updateSfMParams(self):
@@ -369,32 +366,6 @@ class ViewpointWrapper(QObject):
         return QUrl.fromLocalFile(self._undistortedImagePath)
 
 
-def parseSfMJsonFile(sfmJsonFile):
-    """
-    Parse the SfM Json file and return views, poses and intrinsics as three dicts with viewId, poseId and intrinsicId as keys.
-    """
-    if not os.path.exists(sfmJsonFile):
-        return {}, {}, {}
-
-    with open(sfmJsonFile) as jsonFile:
-        report = json.load(jsonFile)
-
-    views = dict()
-    poses = dict()
-    intrinsics = dict()
-
-    for view in report['views']:
-        views[view['viewId']] = view
-
-    for pose in report['poses']:
-        poses[pose['poseId']] = pose['pose']
-
-    for intrinsic in report['intrinsics']:
-        intrinsics[intrinsic['intrinsicId']] = intrinsic
-
-    return views, poses, intrinsics
-
-
 class ActiveNode(QObject):
     """
     Hold one active node for a given NodeType.
@@ -444,6 +415,9 @@ class Reconstruction(UIGraph):
         self._views = None
         self._poses = None
         self._solvedIntrinsics = None
+        self._sfmDataCache = SfMDataCache()
+        self._sfmLoadingFile = None  # SfM file being loaded asynchronously
+        self.sfmResultsLoaded.connect(self._onSfMResultsLoaded)
         self._selectedViewId = None
         self._selectedViewpoint = None
         self._liveSfmManager = LiveSfmManager(self)
@@ -980,11 +954,36 @@ class Reconstruction(UIGraph):
         Update internal views, poses and solved intrinsics based on the current SfM node.
         """
         if not self._sfm or ('outputViewsAndPoses' not in self._sfm.getAttributes().keys()):
-            self._views = dict()
-            self._poses = dict()
-            self._solvedIntrinsics = dict()
-        else:
-            self._views, self._poses, self._solvedIntrinsics = parseSfMJsonFile(self._sfm.outputViewsAndPoses.value)
+            self._setSfMResults(None, (dict(), dict(), dict()))
+            return
+        sfmFile = self._sfm.outputViewsAndPoses.value
+        results = self._sfmDataCache.get(sfmFile)
+        if results is not None:
+            self._setSfMResults(None, results)
+            return
+        # clear outdated results while loading
+        self._setSfMResults(sfmFile, (dict(), dict(), dict()))
+        self.runAsync(self._loadSfMResults, args=(sfmFile,))
+
+    def _loadSfMResults(self, sfmFile):
+        """ Load SfM results from 'sfmFile' into the cache (to be called in a separate thread). """
+        try:
+            self._sfmDataCache.load(sfmFile)
+        except Exception as e:
+            logging.warning("Failed to parse SfM file '{}': {}".format(sfmFile, str(e)))
+        self.sfmResultsLoaded.emit(sfmFile)
+
+    @Slot(str)
+    def _onSfMResultsLoaded(self, sfmFile):
+        # ignore results of an SfM file that is not the current one anymore
+        if sfmFile != self._sfmLoadingFile:
+            return
+        results = self._sfmDataCache.get(sfmFile)
+        self._setSfMResults(None, results if results is not None else (dict(), dict(), dict()))
+
+    def _setSfMResults(self, loadingFile, results):
+        self._sfmLoadingFile = loadingFile
+        self._views, self._poses, self._solvedIntrinsics = results
         self.sfmReportChanged.emit()
 
     def getSfm(self):
@@ -1063,6 +1062,12 @@ class Reconstruction(UIGraph):
         # Should be greater than 2 to avoid the particular case of ""
         return len(viewpoint.metadata.value) > 2
 
+    @Slot(str, result="QVariantMap")
+    def parseViewpointMetadata(self, metadataStr):
+        """ Get the metadata dict of the viewpoint metadata JSON string 'metadataStr' (parsed once and cached). """
+        metadata = parseMetadata(metadataStr)
+        return metadata.data if metadata else {}
+
     def setSelectedViewId(self, viewId):
         if viewId == self._selectedViewId:
             return
@@ -1131,6 +1136,10 @@ class Reconstruction(UIGraph):
     sfmReportChanged = Signal()
     # convenient property for QML binding re-evaluation when sfm report changes
     sfmReport = Property(bool, lambda self: len(self._poses) > 0, notify=sfmReportChanged)
+    # whether SfM results are being loaded
+    sfmReportLoading = Property(bool, lambda self: self._sfmLoadingFile is not None, notify=sfmReportChanged)
+    # emitted from the loading thread when SfM results are available in the cache
+    sfmResultsLoaded = Signal(str)
     sfmAugmented = Signal(Node, Node)
 
     nbCameras = Property(int, reconstructedCamerasCount, notify=sfmReportChanged)
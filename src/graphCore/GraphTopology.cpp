@@ -0,0 +1,201 @@
+#include "GraphTopology.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+namespace meshroom {
+namespace graphCore {
+
+namespace {
+
+enum class Color : std::uint8_t
+{
+    White,
+    Gray,
+    Black
+};
+
+} // namespace
+
+GraphTopology::GraphTopology(std::size_t nbNodes, const std::vector<Edge>& edges)
+  : _inputsOffsets(nbNodes + 1, 0)
+{
+    for(const Edge& edge : edges)
+    {
+        checkNodeIndex(edge.first);
+        checkNodeIndex(edge.second);
+        ++_inputsOffsets[edge.first + 1];
+    }
+    for(std::size_t i = 0; i < nbNodes; ++i)
+        _inputsOffsets[i + 1] += _inputsOffsets[i];
+
+    _inputs.resize(edges.size());
+    std::vector<int> insertPos(_inputsOffsets.begin(), _inputsOffsets.end() - 1);
+    for(const Edge& edge : edges)
+        _inputs[insertPos[edge.first]++] = edge.second;
+
+    // remove duplicated edges (several attributes connected between the same nodes)
+    std::vector<int> offsets(1, 0);
+    offsets.reserve(_inputsOffsets.size());
+    std::size_t nbInputs = 0;
+    for(std::size_t i = 0; i < nbNodes; ++i)
+    {
+        const auto begin = _inputs.begin() + _inputsOffsets[i];
+        const auto end = _inputs.begin() + _inputsOffsets[i + 1];
+        std::sort(begin, end);
+        const auto last = std::unique(begin, end);
+        nbInputs = std::move(begin, last, _inputs.begin() + nbInputs) - _inputs.begin();
+        offsets.push_back(static_cast<int>(nbInputs));
+    }
+    _inputs.resize(nbInputs);
+    _inputs.shrink_to_fit();
+    _inputsOffsets.swap(offsets);
+}
+
+void GraphTopology::checkNodeIndex(int node) const
+{
+    if(node < 0 || static_cast<std::size_t>(node) >= _inputsOffsets.size() - 1)
+        throw std::out_of_range("GraphTopology: invalid node index " + std::to_string(node));
+}
+
+std::vector<int> GraphTopology::topologicalOrder(const std::vector<int>& startNodes) const
+{
+    const std::size_t n = nbNodes();
+    std::vector<int> order;
+    order.reserve(n);
+    std::vector<Color> colors(n, Color::White);
+    // stack of (node, position of the next input to visit)
+    std::vector<std::pair<int, int>> stack;
+
+    auto visit = [&](int root) {
+        checkNodeIndex(root);
+        if(colors[root] != Color::White)
+            return;
+        colors[root] = Color::Gray;
+        stack.emplace_back(root, _inputsOffsets[root]);
+        while(!stack.empty())
+        {
+            std::pair<int, int>& frame = stack.back();
+            const int u = frame.first;
+            if(frame.second == _inputsOffsets[u + 1])
+            {
+                colors[u] = Color::Black;
+                order.push_back(u);
+                stack.pop_back();
+                continue;
+            }
+            const int v = _inputs[frame.second++];
+            if(colors[v] == Color::Gray)
+                throw std::runtime_error("GraphTopology: cycle detected on node " + std::to_string(v));
+            if(colors[v] == Color::White)
+            {
+                colors[v] = Color::Gray;
+                stack.emplace_back(v, _inputsOffsets[v]);
+            }
+        }
+    };
+
+    if(startNodes.empty())
+    {
+        for(std::size_t i = 0; i < n; ++i)
+            visit(static_cast<int>(i));
+    }
+    else
+    {
+        for(int node : startNodes)
+            visit(node);
+    }
+    return order;
+}
+
+std::vector<GraphTopology::Edge> GraphTopology::transitiveReduction(const std::vector<int>& startNodes) const
+{
+    const std::vector<int> order = topologicalOrder(startNodes);
+    const std::size_t n = order.size();
+    const std::size_t nbWords = (n + 63) / 64;
+
+    // local index of each node in the topological order
+    std::vector<int> localIndex(nbNodes(), -1);
+    for(std::size_t i = 0; i < n; ++i)
+        localIndex[order[i]] = static_cast<int>(i);
+
+    // bitset of the nodes reachable from each node (itself excluded), on local indices
+    std::vector<std::uint64_t> reachable(n * nbWords, 0);
+    std::vector<int> inputs;
+    std::vector<Edge> reduction;
+
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        const int u = order[i];
+        inputs.clear();
+        for(int k = _inputsOffsets[u]; k < _inputsOffsets[u + 1]; ++k)
+            inputs.push_back(localIndex[_inputs[k]]);
+        // visit direct inputs from the closest to the farthest in topological order:
+        // any input reaching 'v' has a greater index than 'v' and is therefore accumulated before it
+        std::sort(inputs.begin(), inputs.end(), std::greater<int>());
+
+        std::uint64_t* accumulated = &reachable[i * nbWords];
+        for(int j : inputs)
+        {
+            const std::uint64_t bit = std::uint64_t(1) << (j % 64);
+            if(!(accumulated[j / 64] & bit))
+                reduction.emplace_back(u, order[j]);
+            const std::uint64_t* inputReachable = &reachable[j * nbWords];
+            for(std::size_t w = 0; w < nbWords; ++w)
+                accumulated[w] |= inputReachable[w];
+            accumulated[j / 64] |= bit;
+        }
+    }
+    return reduction;
+}
+
+void GraphTopology::minMaxDepths(std::vector<int>& minDepths, std::vector<int>& maxDepths) const
+{
+    minDepths.assign(nbNodes(), 0);
+    maxDepths.assign(nbNodes(), 0);
+    for(int u : topologicalOrder({}))
+    {
+        const int begin = _inputsOffsets[u];
+        const int end = _inputsOffsets[u + 1];
+        if(begin == end)
+            continue;
+        int depthMin = minDepths[_inputs[begin]] + 1;
+        int depthMax = maxDepths[_inputs[begin]] + 1;
+        for(int k = begin + 1; k < end; ++k)
+        {
+            depthMin = std::min(depthMin, minDepths[_inputs[k]] + 1);
+            depthMax = std::max(depthMax, maxDepths[_inputs[k]] + 1);
+        }
+        minDepths[u] = depthMin;
+        maxDepths[u] = depthMax;
+    }
+}
+
+std::vector<bool> GraphTopology::propagateBlocked(const std::vector<bool>& blocked, const std::vector<bool>& computed) const
+{
+    if(blocked.size() != nbNodes() || computed.size() != nbNodes())
+        throw std::invalid_argument("GraphTopology: 'blocked' and 'computed' must have one value per node");
+
+    std::vector<bool> result(blocked);
+    for(int u : topologicalOrder({}))
+    {
+        // output is already computed and available, does not depend on input connections computability
+        if(computed[u] || result[u])
+            continue;
+        for(int k = _inputsOffsets[u]; k < _inputsOffsets[u + 1]; ++k)
+        {
+            if(result[_inputs[k]])
+            {
+                result[u] = true;
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace graphCore
+} // namespace meshroom
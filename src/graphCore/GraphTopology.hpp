@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace meshroom {
+namespace graphCore {
+
+/**
+ * @brief Compact, integer-indexed representation of a Meshroom graph topology.
+ *
+ * Nodes are identified by their index in [0, nbNodes[.
+ * Edges are given as (node, inputNode) pairs, following the direction used by Graph.dfs:
+ * from a node to the nodes it depends on.
+ * Input adjacency is stored in a CSR layout (offsets + flat list of inputs).
+ */
+class GraphTopology
+{
+public:
+    using Edge = std::pair<int, int>;
+
+    GraphTopology(std::size_t nbNodes, const std::vector<Edge>& edges);
+
+    std::size_t nbNodes() const { return _inputsOffsets.size() - 1; }
+    std::size_t nbEdges() const { return _inputs.size(); }
+
+    /**
+     * @brief Get the nodes reachable from startNodes (all nodes if empty), sorted in topological order:
+     *        input nodes are listed before the nodes depending on them.
+     * @throw std::runtime_error if the graph contains a cycle
+     */
+    std::vector<int> topologicalOrder(const std::vector<int>& startNodes) const;
+
+    /**
+     * @brief Get the transitive reduction of the sub-graph reachable from startNodes (all nodes if empty),
+     *        as (node, inputNode) pairs.
+     */
+    std::vector<Edge> transitiveReduction(const std::vector<int>& startNodes) const;
+
+    /**
+     * @brief Compute the minimal and maximal depth of each node (roots have a depth of 0).
+     */
+    void minMaxDepths(std::vector<int>& minDepths, std::vector<int>& maxDepths) const;
+
+    /**
+     * @brief Propagate computation blocking from inputs to the nodes depending on them.
+     *        An already computed node is never blocked by its inputs.
+     * @param[in] blocked initial blocking state of each node
+     * @param[in] computed whether each node is already computed
+     * @return the propagated blocking state of each node
+     */
+    std::vector<bool> propagateBlocked(const std::vector<bool>& blocked, const std::vector<bool>& computed) const;
+
+private:
+    void checkNodeIndex(int node) const;
+
+    std::vector<int> _inputsOffsets;
+    std::vector<int> _inputs;
+};
+
+} // namespace graphCore
+} // namespace meshroom
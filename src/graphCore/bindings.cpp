@@ -0,0 +1,39 @@
+#include "GraphTopology.hpp"
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+using meshroom::graphCore::GraphTopology;
+
+PYBIND11_MODULE(_graphCore, m)
+{
+    m.doc() = "Native topology kernels for meshroom.core.graph";
+
+    py::class_<GraphTopology>(m, "GraphTopology")
+        .def(py::init<std::size_t, const std::vector<GraphTopology::Edge>&>(),
+             py::arg("nbNodes"), py::arg("edges"),
+             "Build a topology of 'nbNodes' nodes from a list of (node, inputNode) index pairs.")
+        .def_property_readonly("nbNodes", &GraphTopology::nbNodes)
+        .def_property_readonly("nbEdges", &GraphTopology::nbEdges)
+        .def("topologicalOrder", &GraphTopology::topologicalOrder,
+             py::arg("startNodes") = std::vector<int>(),
+             py::call_guard<py::gil_scoped_release>())
+        .def("transitiveReduction", &GraphTopology::transitiveReduction,
+             py::arg("startNodes") = std::vector<int>(),
+             py::call_guard<py::gil_scoped_release>())
+        .def("minMaxDepths",
+             [](const GraphTopology& topology) {
+                 std::vector<int> minDepths;
+                 std::vector<int> maxDepths;
+                 {
+                     py::gil_scoped_release release;
+                     topology.minMaxDepths(minDepths, maxDepths);
+                 }
+                 return py::make_tuple(minDepths, maxDepths);
+             },
+             "Return the (minDepths, maxDepths) lists of all nodes.")
+        .def("propagateBlocked", &GraphTopology::propagateBlocked,
+             py::arg("blocked"), py::arg("computed"),
+             py::call_guard<py::gil_scoped_release>());
+}
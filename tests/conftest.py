@@ -0,0 +1,32 @@
+#!/usr/bin/env python
+# coding:utf-8
+import os
+
+import pytest
+
+from meshroom.core import desc
+from meshroom.core.graph import Graph
+
+
+@pytest.fixture
+def fakeCommandLineNode(tmp_path, monkeypatch):
+    """
+    Get a function creating a node in a new graph, whose command line is replaced by a fake one, ready to compute its
+    chunks with 'node.nodeDesc.processChunk(chunk)' (in any order).
+
+    The fake command line is a function(chunk, cmd, args) called with the command line that would have been run
+    and the arguments of the chunk overriding the ones of the node (unquoted).
+    """
+    def create(nodeType, fakeCommandLine, **params):
+        def processChunk(nodeDesc, chunk, args=None):
+            cmd = nodeDesc.buildCommandLine(chunk, args)
+            fakeCommandLine(chunk, cmd, {name: value.strip('"') if value else value
+                                         for name, value in (args or {}).items()})
+
+        monkeypatch.setattr(desc.CommandLineNode, "processChunk", processChunk)
+        graph = Graph("")
+        graph.cacheDir = str(tmp_path / "cache")
+        node = graph.addNewNode(nodeType, **params)
+        os.makedirs(node.internalFolder)
+        return node
+    return create
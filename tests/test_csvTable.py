@@ -0,0 +1,40 @@
+#!/usr/bin/env python
+# coding:utf-8
+import math
+
+from meshroom.core.csvTable import readColumns, downsample
+
+
+def test_readColumns(tmp_path):
+    csvFile = tmp_path / "response.csv"
+    csvFile.write_text(u"Intensity,Red,Green\n0,0.1,0.2\n1,0.5,x\n2,0.9\n")
+    titles, columns = readColumns(str(csvFile))
+    assert titles == ["Intensity", "Red", "Green"]
+    assert list(columns[0]) == [0, 1, 2]
+    assert list(columns[1]) == [0.1, 0.5, 0.9]
+    # non-numeric and missing values
+    assert columns[2][0] == 0.2 and math.isnan(columns[2][1]) and len(columns[2]) == 2
+
+    # stopped read
+    assert readColumns(str(csvFile), shouldStop=lambda: True) is None
+
+    emptyFile = tmp_path / "empty.csv"
+    emptyFile.write_text(u"")
+    assert readColumns(str(emptyFile)) == ([], [])
+
+
+def test_downsample():
+    values = [float(i % 100) for i in range(10000)]
+    values[5432] = 1000.0
+    values[7000] = -5.0
+    assert downsample(values, 0) == list(enumerate(values))
+
+    points = downsample(values, 200)
+    assert len(points) <= 200
+    indices = [i for i, _ in points]
+    assert indices == sorted(set(indices))
+    assert all(values[i] == v for i, v in points)
+    # extrema are kept
+    assert (5432, 1000.0) in points and (7000, -5.0) in points
+
+    assert downsample([1.0, float('nan'), 3.0], 10) == [(0, 1.0), (2, 3.0)]
@@ -0,0 +1,42 @@
+#!/usr/bin/env python
+# coding:utf-8
+import os
+import threading
+
+import pytest
+
+from meshroom.core.fileUtils import temporaryPath, writeFileAtomic
+
+
+def test_temporaryPath():
+    path = os.path.join("folder", "file.json")
+    tmpPath = temporaryPath(path)
+    assert os.path.dirname(tmpPath) == "folder" and tmpPath.endswith(".json")
+    assert tmpPath != path and tmpPath != temporaryPath(path)
+
+
+def test_writeFileAtomic(tmp_path):
+    path = str(tmp_path / "file.txt")
+    writeFileAtomic(path, lambda f: f.write("first"))
+    writeFileAtomic(path, lambda f: f.write("second"))
+    assert open(path).read() == "second"
+
+    # failed write: previous content is kept, no temporary file is left
+    def failingWrite(f):
+        f.write("partial")
+        raise RuntimeError()
+    with pytest.raises(RuntimeError):
+        writeFileAtomic(path, failingWrite)
+    assert open(path).read() == "second"
+    assert os.listdir(str(tmp_path)) == ["file.txt"]
+
+    # concurrent writers of the same file
+    writers = [threading.Thread(target=writeFileAtomic, args=(path, lambda f, i=i: f.write(str(i) * 10000)))
+               for i in range(8)]
+    for w in writers:
+        w.start()
+    for w in writers:
+        w.join()
+    content = open(path).read()
+    assert len(content) == 10000 and len(set(content)) == 1
+    assert os.listdir(str(tmp_path)) == ["file.txt"]
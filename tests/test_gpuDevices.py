@@ -0,0 +1,154 @@
+#!/usr/bin/env python
+# coding:utf-8
+import threading
+import time
+
+from meshroom.core import gpuDevices
+from meshroom.core.gpuDevices import GpuDevice, DevicePool, availableDevices
+from meshroom.core.taskManager import TaskThread, State
+
+
+def test_availableDevices(monkeypatch):
+    monkeypatch.setenv("CUDA_VISIBLE_DEVICES", "GPU-a1,GPU-b2")
+    gpuDevices.resetDevices()
+    # devices Meshroom is restricted to, in the order of its environment
+    assert [d.id for d in availableDevices()] == ["GPU-a1", "GPU-b2"]
+    env = availableDevices()[1].environment({"CUDA_VISIBLE_DEVICES": "GPU-a1,GPU-b2"})
+    assert env == {"MESHROOM_GPU_DEVICE": "GPU-b2", "CUDA_VISIBLE_DEVICES": "GPU-b2"}
+
+    monkeypatch.setenv("MESHROOM_GPU_DEVICES", "0, 2")
+    gpuDevices.resetDevices()
+    assert [d.id for d in availableDevices()] == ["0", "2"]
+    env = availableDevices()[1].environment({"PATH": "/bin"})
+    assert env == {"PATH": "/bin", "MESHROOM_GPU_DEVICE": "2", "CUDA_VISIBLE_DEVICES": "2",
+                   "CUDA_DEVICE_ORDER": "PCI_BUS_ID"}
+
+    monkeypatch.setenv("MESHROOM_FAKE_GPUS", "3")
+    gpuDevices.resetDevices()
+    devices = availableDevices()
+    assert [d.id for d in devices] == ["0", "1", "2"] and all(d.fake for d in devices)
+    # fake devices do not restrict the visible devices
+    assert "CUDA_VISIBLE_DEVICES" not in devices[0].environment({})
+    gpuDevices.resetDevices()
+
+
+def test_devicesReadAtTaskStart(monkeypatch):
+    monkeypatch.setenv("MESHROOM_FAKE_GPUS", "3")
+    gpuDevices.resetDevices()
+    assert len(availableDevices()) == 3
+    monkeypatch.setenv("MESHROOM_FAKE_GPUS", "2")
+    assert len(availableDevices()) == 3
+    # a new computation reads the devices of the current environment
+    TaskThread(FakeManager()).run()
+    assert len(availableDevices()) == 2
+    gpuDevices.resetDevices()
+
+
+class FakeChunk(object):
+    def __init__(self, tracker, fail=False):
+        self.tracker = tracker
+        self.fail = fail
+        self.gpuDevice = None
+        self.device = None
+
+    def isFinishedOrRunning(self):
+        return self.device is not None
+
+    def isStopped(self):
+        return False
+
+    def process(self, forceCompute):
+        self.device = self.gpuDevice
+        self.tracker.start(self.device)
+        time.sleep(0.05)
+        self.tracker.end(self.device)
+        if self.fail:
+            raise RuntimeError("chunk failure")
+
+
+class Tracker(object):
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.busy = set()
+        self.maxConcurrent = 0
+
+    def start(self, device):
+        with self.lock:
+            assert device not in self.busy
+            self.busy.add(device)
+            self.maxConcurrent = max(self.maxConcurrent, len(self.busy))
+
+    def end(self, device):
+        with self.lock:
+            self.busy.remove(device)
+
+
+class FakeNode(object):
+    nodeType = "DepthMap"
+
+    def __init__(self, nbChunks, tracker, fail=False):
+        self.chunks = [FakeChunk(tracker, fail) for _ in range(nbChunks)]
+
+    def clearSubmittedChunks(self):
+        pass
+
+
+class FakeGraph(object):
+    """ Graph whose traversal is not thread-safe. """
+    def __init__(self, nodes):
+        self.nodes = nodes
+        self.traversals = Tracker()
+
+    def dfsOnDiscover(self, startNodes, reverse):
+        self.traversals.start(None)
+        time.sleep(0.01)
+        self.traversals.end(None)
+        return startNodes + self.nodes, []
+
+
+class FakeManager(object):
+    def __init__(self, nodes=(), graph=None):
+        self._nodesToProcess = list(nodes)
+        self._graph = graph
+
+
+def test_chunksOnDevices():
+    tracker = Tracker()
+    node = FakeNode(8, tracker)
+    thread = TaskThread(FakeManager())
+    thread._state = State.RUNNING
+    devices = [GpuDevice(str(i), fake=True) for i in range(4)]
+    assert thread._processChunksOnDevices(0, node, devices)
+    # all chunks computed, 4 at once on distinct devices
+    assert all(chunk.device in devices for chunk in node.chunks)
+    assert tracker.maxConcurrent == 4
+    assert all(chunk.gpuDevice is None for chunk in node.chunks)
+
+
+def test_chunkErrorsOnDevices():
+    node = FakeNode(8, Tracker(), fail=True)
+    following = [FakeNode(1, Tracker()) for _ in range(3)]
+    graph = FakeGraph(following)
+    manager = FakeManager([node] + following, graph)
+    thread = TaskThread(manager)
+    thread._state = State.RUNNING
+    devices = [GpuDevice(str(i), fake=True) for i in range(4)]
+    assert thread._processChunksOnDevices(0, node, devices)
+    # failures are handled one at a time: the following nodes are removed once
+    assert graph.traversals.maxConcurrent == 1
+    assert manager._nodesToProcess == [node]
+
+
+def test_devicePool():
+    devices = [GpuDevice("0"), GpuDevice("1")]
+    pool = DevicePool(devices)
+    a, b = pool.acquire(), pool.acquire()
+    assert {a, b} == set(devices)
+    acquired = []
+    waiting = threading.Thread(target=lambda: acquired.append(pool.acquire()))
+    waiting.start()
+    time.sleep(0.05)
+    assert not acquired
+    pool.release(a)
+    waiting.join(1)
+    assert acquired == [a]
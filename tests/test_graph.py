@@ -276,3 +276,139 @@ def test_duplicate_nodes():
     assert nMap[n2].input.getLinkParam() == nMap[n1].output
     assert nMap[n3].input.getLinkParam() == nMap[n1].output
     assert nMap[n3].input2.getLinkParam() == nMap[n2].output
+
+
+def test_flow_edges_cache():
+    graph = Graph('Test flowEdges cache')
+
+    # A - B - C
+    #  \-----/
+    A = graph.addNewNode('Ls', input='/tmp')
+    B = graph.addNewNode('AppendText', inputText=A.output)
+    C = graph.addNewNode('AppendFiles', input=A.output, input2=B.output)
+
+    assert set(graph.flowEdges()) == {(B, A), (C, B)}
+    assert set(graph.flowEdges(startNodes=[B])) == {(B, A)}
+    assert set(graph.flowEdges(startNodes=[C])) == {(B, A), (C, B)}
+
+    # topology change invalidates cached results
+    graph.removeEdge(C.input2)
+    assert set(graph.flowEdges()) == {(B, A), (C, A)}
+    assert set(graph.flowEdges(startNodes=[C])) == {(C, A)}
+
+
+def test_dfs_deep_graph():
+    import sys
+    from meshroom.core.graph import GraphModification
+
+    graph = Graph('Test deep graph')
+    depth = sys.getrecursionlimit() + 100
+    with GraphModification(graph):
+        nodes = [graph.addNewNode('Ls', input='/tmp')]
+        for i in range(depth):
+            nodes.append(graph.addNewNode('Ls', input=nodes[-1].output))
+
+    visitedNodes, edges = graph.dfsOnFinish(startNodes=[nodes[-1]])
+    assert visitedNodes == nodes
+    assert len(edges) == depth
+    assert nodes[-1].depth == depth
+
+
+def test_dfs_stop_branch_visit():
+    from meshroom.core.exception import StopBranchVisit
+    from meshroom.core.graph import Visitor
+
+    graph = Graph('Test StopBranchVisit')
+
+    # A - B - C
+    #  \
+    #   D
+    A = graph.addNewNode('Ls', input='/tmp')
+    B = graph.addNewNode('Ls', input=A.output)
+    C = graph.addNewNode('Ls', input=B.output)
+    D = graph.addNewNode('Ls', input=A.output)
+
+    discovered = []
+    finished = []
+    finishedEdges = []
+
+    def discoverVertex(vertex, graph):
+        discovered.append(vertex)
+        if vertex is B:
+            raise StopBranchVisit()
+
+    visitor = Visitor(reverse=True, dependenciesOnly=False)
+    visitor.discoverVertex = discoverVertex
+    visitor.finishVertex = lambda vertex, graph: finished.append(vertex)
+    visitor.finishEdge = lambda edge, graph: finishedEdges.append(edge)
+    graph.dfs(visitor, startNodes=[A])
+
+    assert set(discovered) == {A, B, D}
+    assert set(finished) == {A, D}
+    assert set(finishedEdges) == {(A, B), (A, D)}
+
+
+def test_update_status_from_cache(tmp_path):
+    import os
+    from meshroom.core.fileUtils import replaceFile
+    from meshroom.core.node import Status
+
+    graph = Graph('Test status from cache')
+    graph.cacheDir = str(tmp_path)
+    A = graph.addNewNode('Ls', input='/tmp')
+    B = graph.addNewNode('Ls', input=A.output)
+    chunkA = A.chunks[0]
+    chunkB = B.chunks[0]
+
+    A.upgradeStatusTo(Status.SUCCESS)
+    chunkA.status.reset()
+    graph.updateStatusFromCache(force=True)
+    assert chunkA.status.status == Status.SUCCESS
+    assert chunkB.status.status == Status.NONE
+
+    # unchanged status file is not loaded again
+    chunkA.status.status = Status.ERROR
+    A.dirty = True
+    graph.updateStatusFromCache()
+    assert chunkA.status.status == Status.ERROR
+
+    # status file replaced by a new file of the same size and modification time is loaded again
+    fileStat = os.stat(chunkA.statusFile)
+    newFile = chunkA.statusFile + '.new'
+    with open(chunkA.statusFile) as src, open(newFile, 'w') as dst:
+        dst.write(src.read())
+    os.utime(newFile, ns=(fileStat.st_atime_ns, fileStat.st_mtime_ns))
+    replaceFile(newFile, chunkA.statusFile)
+    A.dirty = True
+    graph.updateStatusFromCache()
+    assert chunkA.status.status == Status.SUCCESS
+
+    # removed status file resets the status
+    os.remove(chunkA.statusFile)
+    graph.updateStatusFromCache()
+    assert chunkA.status.status == Status.NONE
+
+
+def test_command_line_arguments(tmp_path):
+    graph = Graph('')
+    graph.cacheDir = str(tmp_path)
+    node = graph.addNewNode('Meshing', input='/data/my project/sfm.sfm')
+    cmd = node.nodeDesc.buildCommandLine(node.chunks[0])
+    assert '--input "/data/my project/sfm.sfm"' in cmd and '--boundingBox' not in cmd
+
+    args = {
+        'input': '"/data/other project/sfm.sfm"',  # quoted path with spaces
+        'depthMapsFolder': '"/data/depth maps"',  # empty value on the node
+        'boundingBox': '0,0,0,0,0,0,1,1,1',  # disabled attribute
+        'outputMesh': None,  # removed argument
+        'extraArgument': 3,  # not an attribute
+    }
+    cmd = node.nodeDesc.buildCommandLine(node.chunks[0], args)
+    assert '--input "/data/other project/sfm.sfm"' in cmd and 'my project' not in cmd
+    assert '--depthMapsFolder "/data/depth maps"' in cmd and cmd.count('--depthMapsFolder') == 1
+    assert '--boundingBox 0,0,0,0,0,0,1,1,1' in cmd
+    assert '--outputMesh' not in cmd and '--output ' in cmd
+    assert cmd.endswith(' --extraArgument 3')
+    # the node command line variables are unchanged
+    assert node.nodeDesc.buildCommandLine(node.chunks[0]) == node.nodeDesc.buildCommandLine(node.chunks[0], {})
+    assert 'other project' not in node.nodeDesc.buildCommandLine(node.chunks[0])
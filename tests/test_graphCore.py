@@ -0,0 +1,96 @@
+#!/usr/bin/env python
+# coding:utf-8
+import random
+
+import pytest
+
+from meshroom.core import graph as graphModule
+from meshroom.core.graph import Graph
+
+pytestmark = pytest.mark.skipif(graphModule.graphCore is None, reason="native graph core module is not built")
+
+
+def chainGraph():
+    graph = Graph('')
+    tA = graph.addNewNode('Ls', input='/tmp')
+    tB = graph.addNewNode('AppendText', inputText='echo B')
+    tC = graph.addNewNode('AppendText', inputText='echo C')
+    graph.addEdges(
+        (tA.output, tB.input),
+        (tB.output, tC.input),
+        )
+    return graph
+
+
+def transitiveGraph():
+    graph = Graph('')
+    tA = graph.addNewNode('Ls', input='/tmp')
+    tB = graph.addNewNode('AppendText', inputText='echo B')
+    tC = graph.addNewNode('AppendText', inputText='echo C')
+    tD = graph.addNewNode('AppendFiles')
+    tE = graph.addNewNode('AppendFiles')
+    graph.addEdges(
+        (tA.output, tB.input),
+        (tA.output, tC.input),
+        (tB.output, tD.input),
+        (tC.output, tD.input2),
+        (tD.output, tE.input),
+        (tA.output, tE.input2),
+        )
+    return graph
+
+
+def randomGraph(seed, nbNodes=40):
+    """ Random DAG whose nodes take up to 4 inputs from the nodes created before them. """
+    rng = random.Random(seed)
+    graph = Graph('')
+    nodes = []
+    for i in range(nbNodes):
+        if i < 3:
+            nodes.append(graph.addNewNode('Ls', input='/tmp'))
+            continue
+        node = graph.addNewNode('AppendFiles')
+        inputs = [node.input, node.input2, node.input3, node.input4]
+        for inputNode, attribute in zip(rng.sample(nodes, min(len(nodes), rng.randint(1, 4))), inputs):
+            graph.addEdge(inputNode.output, attribute)
+        nodes.append(node)
+    return graph
+
+
+def topologicalData(graph, startNodes):
+    """ Get the topological data of 'graph' computed with the graph core currently in use. """
+    graph._topologyCache.clear()
+    graph.updateNodesTopologicalData()
+    return {
+        "flowEdges": set(graph.flowEdges()),
+        "startFlowEdges": set(graph.flowEdges(startNodes)),
+        "minMaxDepths": dict(graph._nodesMinMaxDepths),
+        "canCompute": {node: graph.canCompute(node) for node in graph.nodes},
+    }
+
+
+@pytest.mark.parametrize("createGraph", [chainGraph, transitiveGraph] + [
+    lambda seed=seed: randomGraph(seed) for seed in range(5)])
+def test_nativePythonParity(createGraph, monkeypatch):
+    graph = createGraph()
+    # start from an intermediate node: only a part of the graph is visited
+    startNodes = [list(graph.nodes)[len(graph.nodes) // 2]]
+    native = topologicalData(graph, startNodes)
+    monkeypatch.setattr(graphModule, "graphCore", None)
+    python = topologicalData(graph, startNodes)
+    assert native == python
+
+
+@pytest.mark.parametrize("seed", range(5))
+def test_topologicalOrder(seed):
+    graph = randomGraph(seed)
+    nodes, nodeIndex, topology = graph._getIndexedTopology(dependenciesOnly=False)
+    startNodes = [list(graph.nodes)[len(graph.nodes) // 2]]
+    for start in (None, startNodes):
+        order = [nodes[i] for i in topology.topologicalOrder([nodeIndex[n] for n in start] if start else [])]
+        # same nodes as the DFS, inputs listed before the nodes depending on them
+        assert set(order) == set(graph.dfsOnFinish(start)[0])
+        position = {node: i for i, node in enumerate(order)}
+        for edge in graph.edges:
+            if edge.dst.node in position:
+                assert position[edge.src.node] < position[edge.dst.node]
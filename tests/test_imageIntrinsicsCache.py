@@ -0,0 +1,129 @@
+#!/usr/bin/env python
+# coding:utf-8
+import json
+import os
+import time
+
+from meshroom.core.imageIntrinsicsCache import ImageIntrinsicsCache, paramsKey
+from meshroom.core.node import Node
+from meshroom.nodes.aliceVision.CameraInit import shardViews
+
+
+def test_cacheEntries(tmp_path):
+    image = tmp_path / "image.jpg"
+    image.write_text(u"image")
+    cache = ImageIntrinsicsCache(str(tmp_path / "cache"))
+    key = paramsKey({"defaultFieldOfView": 45.0})
+    assert cache.get(str(image), key) is None
+
+    view, intrinsic = {"path": str(image), "viewId": 1, "intrinsicId": 2}, {"intrinsicId": 2}
+    cache.add(str(image), key, view, intrinsic)
+    assert cache.get(str(image), key) == (view, intrinsic)
+    assert ImageIntrinsicsCache(str(tmp_path / "cache")).get(str(image), key) == (view, intrinsic)
+    # other parameters
+    assert cache.get(str(image), paramsKey({"defaultFieldOfView": 50.0})) is None
+    # modified image
+    time.sleep(0.01)
+    image.write_text(u"modified image")
+    assert cache.get(str(image), key) is None
+    # missing image
+    assert cache.get(str(tmp_path / "missing.jpg"), key) is None
+
+
+def test_incrementalBuildIntrinsics(tmp_path, monkeypatch):
+    images = []
+    for i in range(4):
+        image = tmp_path / "img{}.jpg".format(i)
+        image.write_text(u"image")
+        images.append(str(image))
+    processed = []
+
+    def runCameraInit(node, views, intrinsics, maxProcesses=None):
+        processed.append([v["path"] for v in views])
+        results = []
+        for view in views:
+            index = images.index(view["path"])
+            intrinsicId = 10 + index % 2
+            results.append(({"path": view["path"], "viewId": 100 + index, "intrinsicId": intrinsicId,
+                             "metadata": json.dumps({"index": index})},
+                            {"intrinsicId": intrinsicId, "width": 100 * intrinsicId}))
+        return results
+
+    node = Node("CameraInit")
+    nodeDesc = node.nodeDesc
+    monkeypatch.setattr(nodeDesc, "runCameraInit", runCameraInit)
+    cache = ImageIntrinsicsCache(str(tmp_path / "cache"))
+
+    views, intrinsics = nodeDesc.buildIntrinsics(node, images[:2], cache=cache)
+    assert processed == [images[:2]]
+    assert [v["viewId"] for v in views] == [100, 101]
+    assert sorted(i["intrinsicId"] for i in intrinsics) == [10, 11]
+
+    # only new images are processed
+    node.viewpoints.value = views
+    node.intrinsics.value = intrinsics
+    views, intrinsics = nodeDesc.buildIntrinsics(node, images[2:], cache=cache)
+    assert processed[1:] == [images[2:]]
+    assert [v["viewId"] for v in views] == [100, 101, 102, 103]
+    assert sorted(i["intrinsicId"] for i in intrinsics) == [10, 11]
+
+    # images already processed once with the same existing intrinsics are found in the cache
+    views, intrinsics = nodeDesc.buildIntrinsics(Node("CameraInit"), images, cache=cache)
+    assert processed[2:] == [images[2:]]
+    assert [v["viewId"] for v in views] == [100, 101, 102, 103]
+    node = Node("CameraInit")
+    node.intrinsics.value = intrinsics[:1]
+    nodeDesc.buildIntrinsics(node, images[:1], cache=cache)
+    assert processed[3:] == [images[:1]]
+    nodeDesc.buildIntrinsics(node, images[:1], cache=cache)
+    assert len(processed) == 4
+
+
+def test_toolPathsMatching(tmp_path, monkeypatch):
+    image = tmp_path / "img.jpg"
+    image.write_text(u"image")
+    # path given with a different form than the one written by the tool
+    inputPath = str(tmp_path / "sub" / ".." / "img.jpg")
+
+    def runCameraInit(node, views, intrinsics, maxProcesses=None):
+        return [({"path": str(image), "viewId": 1, "intrinsicId": 2, "metadata": "{}"}, {"intrinsicId": 2})]
+
+    node = Node("CameraInit")
+    monkeypatch.setattr(node.nodeDesc, "runCameraInit", runCameraInit)
+    views, intrinsics = node.nodeDesc.buildIntrinsics(node, [inputPath], cache=ImageIntrinsicsCache(str(tmp_path / "cache")))
+    assert [v["viewId"] for v in views] == [1]
+
+
+def test_cleanup(tmp_path):
+    images = []
+    for i in range(5):
+        image = tmp_path / "image{}.jpg".format(i)
+        image.write_text(u"image")
+        images.append(str(image))
+    cache = ImageIntrinsicsCache(str(tmp_path / "cache"))
+    key = paramsKey({})
+    for i, image in enumerate(images):
+        cache.add(image, key, {"path": image}, None)
+        os.utime(cache.entryPath(image, key), (i, i))
+    cache.maxCacheSize = 3 * os.path.getsize(cache.entryPath(images[0], key))
+    assert cache.cleanupIfNeeded() == 2
+    # oldest entries have been removed
+    assert [cache.get(image, key) is not None for image in images] == [False, False, True, True, True]
+    # at most one cleanup per interval
+    cache.maxCacheSize = 0
+    assert cache.cleanupIfNeeded() == 0
+    assert cache.cleanup() == 3
+
+
+def test_shardViews():
+    views = [{"path": "/a/{}.jpg".format(i)} for i in range(3)] + [{"path": "/b/{}.jpg".format(i)} for i in range(4)] + \
+            [{"path": "/c/{}.jpg".format(i)} for i in range(10)] + [{"path": "/a/3.jpg"}]
+    shards = shardViews(views, 3)
+    assert sorted(sum(shards, []), key=views.index) == views
+    paths = [[v["path"] for v in shard] for shard in shards]
+    # folders are contiguous, and kept in a shard when they fit
+    assert paths[0] == ["/a/0.jpg", "/a/1.jpg", "/a/2.jpg", "/a/3.jpg"]
+    assert paths[1] == ["/b/{}.jpg".format(i) for i in range(4)]
+    # larger folders are split in contiguous parts
+    assert paths[2:] == [["/c/{}.jpg".format(i) for i in range(6)], ["/c/{}.jpg".format(i) for i in range(6, 10)]]
+    assert shardViews(views, 1) == [sorted(views, key=lambda v: v["path"][:2])]
@@ -0,0 +1,127 @@
+#!/usr/bin/env python
+# coding:utf-8
+import json
+import os
+import threading
+import time
+
+from meshroom.nodes.aliceVision.ImageProcessing import resolveInputImages, splitRange
+
+
+def test_resolveInputImages(tmp_path):
+    for name in ["img_001.jpg", "img_002.JPG", "img_010.png", "other.jpg", "notes.txt"]:
+        (tmp_path / name).write_text(u"")
+    folder = str(tmp_path)
+    assert resolveInputImages(folder) == sorted(os.path.join(folder, f) for f in
+                                                ["img_001.jpg", "img_002.JPG", "img_010.png", "other.jpg"])
+    assert resolveInputImages(os.path.join(folder, "img_00#.*")) == [os.path.join(folder, "img_001.jpg"),
+                                                                     os.path.join(folder, "img_002.JPG")]
+    assert resolveInputImages(os.path.join(folder, "img_@.png")) == [os.path.join(folder, "img_010.png")]
+    assert resolveInputImages(os.path.join(folder, "other.jpg")) == [os.path.join(folder, "other.jpg")]
+    assert resolveInputImages(os.path.join(folder, "missing", "*")) == []
+
+
+def test_splitRange():
+    items = list(range(10))
+    for nbChunks in range(1, 12):
+        parts = [splitRange(items, i, nbChunks) for i in range(nbChunks)]
+        assert sum(parts, []) == items
+        assert max(len(p) for p in parts) - min(len(p) for p in parts) <= 1
+
+
+def test_chunkedSfMData(tmp_path, fakeCommandLineNode):
+    sfmFile = str(tmp_path / "input.sfm")
+    views = [{"viewId": str(i), "path": str(tmp_path / "img{}.jpg".format(i))} for i in range(100)]
+    with open(sfmFile, "w") as f:
+        json.dump({"version": ["1", "0", "0"], "views": views, "intrinsics": []}, f)
+
+    def imageProcessing(chunk, cmd, args):
+        # fake tool: write an image per view in the output folder and the SfMData referencing them
+        with open(args["input"]) as f:
+            sfmData = json.load(f)
+        for view in sfmData["views"]:
+            view["path"] = os.path.join(args["output"], os.path.basename(view["path"]).replace(".jpg", ".exr"))
+            open(view["path"], "w").close()
+        with open(os.path.join(args["output"], "input.sfm"), "w") as f:
+            json.dump(sfmData, f)
+
+    node = fakeCommandLineNode("ImageProcessing", imageProcessing, input=sfmFile)
+    assert node.size == 100
+    assert len(node.chunks) == 3
+
+    # chunks can be computed in any order, the last one merges the results
+    for index in [2, 0, 1]:
+        assert not os.path.exists(node.outSfMData.value)
+        node.nodeDesc.processChunk(node.chunks[index])
+
+    with open(node.outSfMData.value) as f:
+        outViews = json.load(f)["views"]
+    assert [v["viewId"] for v in outViews] == [v["viewId"] for v in views]
+    for view in outViews:
+        assert os.path.dirname(view["path"]) == os.path.normpath(node.internalFolder)
+        assert os.path.isfile(view["path"])
+
+
+def test_mergeIntrinsics(tmp_path, fakeCommandLineNode):
+    sfmFile = str(tmp_path / "input.sfm")
+    views = [{"viewId": str(i), "intrinsicId": str(i // 50), "poseId": str(i),
+              "path": str(tmp_path / "img{}.jpg".format(i))} for i in range(100)]
+    with open(sfmFile, "w") as f:
+        json.dump({"views": views, "intrinsics": [], "poses": []}, f)
+
+    def imageProcessing(chunk, cmd, args):
+        # fake tool: only the intrinsics and poses of the chunk views are written
+        with open(args["input"]) as f:
+            sfmData = json.load(f)
+        sfmData["intrinsics"] = [{"intrinsicId": i} for i in sorted(set(v["intrinsicId"] for v in sfmData["views"]))]
+        sfmData["poses"] = [{"poseId": v["poseId"]} for v in sfmData["views"]]
+        with open(os.path.join(args["output"], "input.sfm"), "w") as f:
+            json.dump(sfmData, f)
+
+    node = fakeCommandLineNode("ImageProcessing", imageProcessing, input=sfmFile)
+    assert len(node.chunks) == 3
+    for chunk in node.chunks:
+        node.nodeDesc.processChunk(chunk)
+    with open(node.outSfMData.value) as f:
+        sfmData = json.load(f)
+    # the second chunk has views of both intrinsics
+    assert [i["intrinsicId"] for i in sfmData["intrinsics"]] == ["0", "1"]
+    assert [p["poseId"] for p in sfmData["poses"]] == [str(i) for i in range(100)]
+
+
+def test_concurrentChunkDone(tmp_path, fakeCommandLineNode, monkeypatch):
+    for i in range(80):
+        (tmp_path / "img{}.jpg".format(i)).write_text(u"")
+    node = fakeCommandLineNode("ImageProcessing", lambda chunk, cmd, args: None, input=str(tmp_path))
+    assert len(node.chunks) == 2
+    merges = []
+
+    def mergeChunks(nodeDesc, node):
+        merges.append(node)
+        time.sleep(0.1)
+
+    monkeypatch.setattr(node.nodeDesc.__class__, "mergeChunks", mergeChunks)
+    for _ in range(5):
+        for chunk in node.chunks:
+            node.nodeDesc.chunkStarted(chunk)
+        # both chunks finish at the same time: they both see all chunks done
+        barrier = threading.Barrier(2)
+        results = []
+
+        def finish(chunk):
+            barrier.wait()
+            results.append(node.nodeDesc.chunkDone(chunk))
+
+        threads = [threading.Thread(target=finish, args=(chunk,)) for chunk in node.chunks]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        assert sorted(results) == [False, True]
+    assert len(merges) == 5
+    # done chunks are not merged again until a chunk is computed again
+    assert not node.nodeDesc.chunkDone(node.chunks[0])
+    node.nodeDesc.chunkStarted(node.chunks[1])
+    assert not node.nodeDesc.chunkDone(node.chunks[0])
+    assert node.nodeDesc.chunkDone(node.chunks[1])
+    assert len(merges) == 6
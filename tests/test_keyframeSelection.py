@@ -0,0 +1,57 @@
+#!/usr/bin/env python
+# coding:utf-8
+import os
+
+from meshroom.core.graph import Graph
+
+
+def mediaParams(tmp_path, nbMedia):
+    return {"mediaPaths": [str(tmp_path / "video{}.mp4".format(i)) for i in range(nbMedia)],
+            "brands": ["brand{}".format(i) for i in range(nbMedia)]}
+
+
+def test_commandLinePerMedia(tmp_path):
+    graph = Graph("")
+    graph.cacheDir = str(tmp_path / "cache")
+    node = graph.addNewNode("KeyframeSelection", **mediaParams(tmp_path, 3))
+    # default settings: synchronized selection of a rig, a single chunk
+    assert len(node.chunks) == 1
+    assert "synchronizedRig" not in node.nodeDesc.buildCommandLine(node.chunks[0])
+    node.useSharpnessSelection.value = False
+    assert len(node.chunks) == 1
+    node.useSparseDistanceSelection.value = False
+    assert len(node.chunks) == 3
+    # media that are not a rig: processed independently whatever the selection
+    node.useSharpnessSelection.value = True
+    node.useSparseDistanceSelection.value = True
+    node.synchronizedRig.value = False
+    assert len(node.chunks) == 3
+    cmd = node.nodeDesc.buildCommandLine(node.chunks[1], node.nodeDesc.mediaArguments(node, 1))
+    assert "video1.mp4" in cmd and "brand1" in cmd
+    assert "video0.mp4" not in cmd and "video2.mp4" not in cmd and "brand2" not in cmd
+    assert node.nodeDesc.chunkFolder(node, 1) in cmd
+    assert cmd.count("--mediaPaths") == 1 and cmd.count("--outputFolder") == 1
+
+
+def test_mergeMedia(tmp_path, fakeCommandLineNode):
+    processed = []
+
+    def keyframeSelection(chunk, cmd, args):
+        processed.append(chunk.index)
+        if args:
+            open(os.path.join(args["outputFolder"], "0001.exr"), "w").close()
+
+    # synchronized selection: processed at once
+    node = fakeCommandLineNode("KeyframeSelection", keyframeSelection, **mediaParams(tmp_path, 3))
+    for chunk in node.chunks:
+        node.nodeDesc.processChunk(chunk)
+    assert processed == [0]
+
+    # regular interval: processed per media and merged into the rig layout
+    node.useSharpnessSelection.value = False
+    node.useSparseDistanceSelection.value = False
+    for index in [1, 2, 0]:
+        node.nodeDesc.processChunk(node.chunks[index])
+    assert processed == [0, 1, 2, 0]
+    for index in range(3):
+        assert os.path.isfile(os.path.join(node.outputFolder.value, "rig", str(index), "0001.exr"))
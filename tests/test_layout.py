@@ -0,0 +1,29 @@
+#!/usr/bin/env python
+# coding:utf-8
+
+from meshroom.core.layout import orderLayers, countCrossings
+
+
+def test_order_layers_removes_crossings():
+    #  a0 -> b1     a0    b0
+    #  a1 -> b0  =>  a1    b1
+    #  b0 -> c1     (c0 follows b0)
+    #  b1 -> c0
+    layers = [['a0', 'a1'], ['b0', 'b1'], ['c0', 'c1']]
+    edges = [('a0', 'b1'), ('a1', 'b0'), ('b0', 'c1'), ('b1', 'c0')]
+    assert countCrossings(layers, edges) == 2
+
+    ordered = orderLayers(layers, edges)
+    assert countCrossings(ordered, edges) == 0
+    # layers content is preserved
+    assert [sorted(layer) for layer in ordered] == [sorted(layer) for layer in layers]
+
+
+def test_order_layers_long_edges():
+    # edges spanning several layers and isolated nodes are supported
+    layers = [['a', 'b'], ['c', 'd', 'e'], ['f', 'g']]
+    edges = [('a', 'g'), ('b', 'f'), ('b', 'd'), ('a', 'e'), ('x', 'a')]
+    ordered = orderLayers(layers, edges)
+    # a -> g and b -> f do not cross
+    assert (ordered[0].index('a') < ordered[0].index('b')) == (ordered[2].index('g') < ordered[2].index('f'))
+    assert sorted(ordered[1]) == ['c', 'd', 'e']
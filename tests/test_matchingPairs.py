@@ -0,0 +1,66 @@
+#!/usr/bin/env python
+# coding:utf-8
+import json
+import os
+
+from meshroom.core.matchingPairs import readPairs, writePairs, pairCosts, partitionPairs
+
+
+def test_readWritePairs(tmp_path):
+    pairsFile = str(tmp_path / "pairs.txt")
+    pairs = [("1", "2"), ("1", "3"), ("2", "3"), ("4", "1")]
+    writePairs(pairs, pairsFile)
+    with open(pairsFile) as f:
+        assert f.read() == "1 2 3\n2 3\n4 1\n"
+    assert readPairs(pairsFile) == pairs
+    # blank lines
+    with open(pairsFile, "w") as f:
+        f.write("\n1 2 3\n\n  \n2 3\n4 1\n\n")
+    assert readPairs(pairsFile) == pairs
+
+
+def test_pairCosts(tmp_path):
+    folder = tmp_path / "features"
+    folder.mkdir()
+    (folder / "1.sift.feat").write_text(u"x" * 100)
+    (folder / "2.sift.feat").write_text(u"x" * 300)
+    costs = pairCosts([("1", "2"), ("1", "3")], [str(folder)], ["sift"])
+    # view 3 has no features file: counted as an average view
+    assert costs == [200 + 100 + 300, 200 + 100 + 200]
+
+
+def test_partitionPairs():
+    # the pairs of the first image are much more expensive
+    pairs = [("0", str(i)) for i in range(1, 4)] + [("1", str(i)) for i in range(2, 20)]
+    costs = [10.0] * 3 + [1.0] * 18
+    parts = partitionPairs(pairs, costs, 3)
+    assert sum(parts, []) == pairs
+    partCosts = [sum(costs[pairs.index(p)] for p in part) for part in parts]
+    assert max(partCosts) - min(partCosts) <= 10.0
+    # fewer pairs than parts
+    assert sum(partitionPairs(pairs[:2], costs[:2], 5), []) == pairs[:2]
+    assert partitionPairs([], [], 2) == [[], []]
+
+
+def test_chunkedMatching(tmp_path, fakeCommandLineNode):
+    sfmFile = str(tmp_path / "sfm.sfm")
+    with open(sfmFile, "w") as f:
+        json.dump({"views": [{"viewId": str(i)} for i in range(50)]}, f)
+    pairsFile = str(tmp_path / "pairs.txt")
+    pairs = [(str(i), str(j)) for i in range(50) for j in range(i + 1, min(i + 5, 50))]
+    writePairs(pairs, pairsFile)
+
+    def featureMatching(chunk, cmd, args):
+        # fake matching: one matches file with the chunk pairs
+        assert "--rangeStart" not in cmd and args["imagePairsList"] in cmd
+        with open(os.path.join(args["output"], "matches.txt"), "w") as f:
+            f.write(open(args["imagePairsList"]).read())
+
+    node = fakeCommandLineNode("FeatureMatching", featureMatching, input=sfmFile, imagePairsList=pairsFile)
+    assert len(node.chunks) == 3
+    for index in [1, 2, 0]:
+        node.nodeDesc.processChunk(node.chunks[index])
+    matched = []
+    for index in range(3):
+        matched += readPairs(os.path.join(node.output.value, "{}.matches.txt".format(index)))
+    assert matched == pairs
@@ -0,0 +1,117 @@
+#!/usr/bin/env python
+# coding:utf-8
+import os
+import time
+
+import pytest
+
+from meshroom.core import meshLod
+
+
+def writeGridMesh(path, n):
+    """ Write a textured n x n vertices grid mesh. """
+    with open(path, 'w') as f:
+        f.write('mtllib mesh.mtl\n')
+        for y in range(n):
+            for x in range(n):
+                f.write('v {} {} 0\n'.format(x, y))
+        for y in range(n):
+            for x in range(n):
+                f.write('vt {} {}\n'.format(x / float(n), y / float(n)))
+        f.write('usemtl material\n')
+        for y in range(n - 1):
+            for x in range(n - 1):
+                a = y * n + x + 1
+                b, c, d = a + 1, a + n, a + n + 1
+                f.write('f {0}/{0} {1}/{1} {3}/{3}\n'.format(a, b, c, d))
+                f.write('f {0}/{0} {3}/{3} {2}/{2}\n'.format(a, b, c, d))
+
+
+def readObj(path):
+    vertices, texCoords, faces = [], 0, []
+    with open(path) as f:
+        for line in f:
+            if line.startswith('v '):
+                vertices.append(line)
+            elif line.startswith('vt '):
+                texCoords += 1
+            elif line.startswith('f '):
+                faces.append([[int(i) for i in c.split('/')] for c in line.split()[1:]])
+    return vertices, texCoords, faces
+
+
+def test_meshLevels(tmp_path):
+    mesh = str(tmp_path / "mesh.obj")
+    writeGridMesh(mesh, 100)
+    assert meshLod.levelPaths(mesh) == []
+
+    manifest = meshLod.buildLevels(mesh, budgets=[100, 1000, 100000])
+    assert manifest['vertexCount'] == 10000
+    assert manifest['faceCount'] == 2 * 99 * 99
+    # no level for budgets larger than the source
+    assert len(manifest['levels']) == 2
+    paths = meshLod.levelPaths(mesh)
+    assert [os.path.basename(p) for p in paths] == ['level0.obj', 'level1.obj']
+    # temporary vertex mappings and faces are removed
+    assert sorted(os.listdir(meshLod.sidecarFolder(mesh))) == ['level0.obj', 'level1.obj', meshLod.manifestName]
+
+    previousCount = 0
+    for path, level in zip(paths, manifest['levels']):
+        vertices, texCoords, faces = readObj(path)
+        assert len(vertices) == level['vertexCount']
+        assert len(faces) == level['faceCount'] > 0
+        assert previousCount < len(vertices) < manifest['vertexCount']
+        previousCount = len(vertices)
+        for face in faces:
+            assert len(set(v for v, _ in face)) == 3
+            assert all(1 <= v <= len(vertices) and 1 <= vt <= texCoords for v, vt in face)
+        # material library is still found from the sidecar folder
+        with open(path) as f:
+            assert os.path.normpath(os.path.join(os.path.dirname(path), f.readlines()[1].split()[1])) == \
+                os.path.normpath(str(tmp_path / "mesh.mtl"))
+
+    # up-to-date sidecar is reused
+    assert meshLod.buildLevels(mesh, budgets=[10]) == manifest
+    # modified source: outdated sidecar
+    time.sleep(0.01)
+    writeGridMesh(mesh, 50)
+    assert meshLod.levelPaths(mesh) == []
+    assert meshLod.buildLevels(mesh, budgets=[100])['vertexCount'] == 2500
+    assert len(meshLod.levelPaths(mesh)) == 1
+
+
+def test_pointCloudLevels(tmp_path):
+    pointCloud = str(tmp_path / "points.obj")
+    with open(pointCloud, 'w') as f:
+        for i in range(5000):
+            f.write('v {} {} {} 1 0.5 0\n'.format(i % 70, i // 70, (i * 7) % 3))
+    manifest = meshLod.buildLevels(pointCloud, budgets=[200])
+    assert manifest['faceCount'] == 0
+    vertices, _, faces = readObj(meshLod.levelPaths(pointCloud)[0])
+    assert 0 < len(vertices) < 5000 and not faces
+    # colors are kept
+    assert all(line.split()[4:] == ['1', '0.5', '0'] for line in vertices)
+
+
+def test_volumetricLevelsBudget(tmp_path):
+    # noisy volume: occupies many more cells than a surface at the same resolution
+    import random
+    random.seed(0)
+    pointCloud = str(tmp_path / "volume.obj")
+    with open(pointCloud, 'w') as f:
+        for i in range(20000):
+            f.write('v {} {} {}\n'.format(random.random(), random.random(), random.random()))
+    manifest = meshLod.buildLevels(pointCloud, budgets=[500, 5000])
+    assert len(manifest['levels']) == 2
+    for budget, level in zip([500, 5000], manifest['levels']):
+        assert 0 < level['vertexCount'] <= budget
+        assert len(readObj(os.path.join(meshLod.sidecarFolder(pointCloud), level['file']))[0]) == level['vertexCount']
+
+
+def test_cancelledBuild(tmp_path):
+    mesh = str(tmp_path / "mesh.obj")
+    writeGridMesh(mesh, 20)
+    with pytest.raises(meshLod.BuildCancelled):
+        meshLod.buildLevels(mesh, budgets=[10], shouldStop=lambda: True)
+    # no partial sidecar
+    assert os.listdir(str(tmp_path)) == ["mesh.obj"]
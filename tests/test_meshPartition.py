@@ -0,0 +1,197 @@
+#!/usr/bin/env python
+# coding:utf-8
+import json
+import os
+import sys
+
+import pytest
+
+from meshroom.core.graph import Graph
+from meshroom.core import meshPartition
+from meshroom.core.meshPartition import Box, Partition, gridDimensions, estimateBoundingBox, iterSfMData, mergeMeshes, mergeStructures
+
+
+def test_box():
+    box = Box((1.0, 2.0, 3.0), (30.0, 45.0, 60.0), (2.0, 3.0, 4.0))
+    p = (0.3, -0.2, 0.9)
+    assert box.toLocal(box.toWorld(p)) == pytest.approx(p)
+    sub = box.subBox((0.0, 0.0, 0.0), (1.0, 1.0, 1.0))
+    assert sub.toWorld((-1.0, -1.0, -1.0)) == pytest.approx(box.toWorld((0.0, 0.0, 0.0)))
+    assert sub.toWorld((1.0, 1.0, 1.0)) == pytest.approx(box.toWorld((1.0, 1.0, 1.0)))
+
+
+def test_gridDimensions():
+    assert gridDimensions(4, Box(scale=(10.0, 1.0, 10.0))) == (2, 1, 2)
+    assert gridDimensions(3, Box(scale=(1.0, 5.0, 1.0))) == (1, 3, 1)
+    assert gridDimensions(1, Box()) == (1, 1, 1)
+
+
+def test_partitionCells():
+    partition = Partition(Box(scale=(2.0, 1.0, 1.0)), 2, overlap=0.25)
+    assert partition.cellOf((-1.0, 0.0, 0.0)) == 0
+    assert partition.cellOf((1.0, 0.0, 0.0)) == 1
+    # outside of the box: border cells
+    assert partition.cellOf((-5.0, 0.0, 0.0)) == 0
+    assert partition.cellOf((5.0, 3.0, 0.0)) == 1
+    # cells overlap
+    assert partition.cellBox(0).toWorld((1.0, 0.0, 0.0))[0] == pytest.approx(0.5)
+    assert partition.cellBox(1).toWorld((-1.0, 0.0, 0.0))[0] == pytest.approx(-0.5)
+
+
+def writeCellMesh(path, xs):
+    # a strip of triangles along x
+    with open(path, "w") as f:
+        for x in xs:
+            f.write("v {} 0 0 255 0 0\nv {} 1 0 255 0 0\n".format(x, x))
+        for i in range(len(xs) - 1):
+            a = 2 * i + 1
+            f.write("f {} {} {}\nf {} {} {}\n".format(a, a + 2, a + 1, a + 1, a + 2, a + 3))
+
+
+def test_mergeMeshes(tmp_path):
+    partition = Partition(Box(scale=(2.0, 1.0, 1.0)), 2, overlap=0.5)
+    writeCellMesh(str(tmp_path / "0.obj"), [-2.0, -1.0, 0.0, 1.0])
+    writeCellMesh(str(tmp_path / "1.obj"), [-1.0, 0.0, 1.0, 2.0])
+    output = str(tmp_path / "mesh.obj")
+    mergeMeshes([str(tmp_path / "0.obj"), str(tmp_path / "1.obj")], partition, output)
+    with open(output) as f:
+        lines = f.read().splitlines()
+    vertices = [l for l in lines if l.startswith("v ")]
+    faces = [[int(i) for i in l.split()[1:]] for l in lines if l.startswith("f ")]
+    # each strip segment is kept once
+    assert len(faces) == 8
+    # the vertices at the cell border are welded: both halves of the strip are connected
+    assert len(vertices) == 10
+    assert len([v for v in vertices if float(v.split()[1]) == 0.0]) == 2
+    assert set(sum(faces[:4], [])) & set(sum(faces[4:], []))
+    assert all(1 <= i <= len(vertices) for face in faces for i in face)
+    assert all(v.endswith("255 0 0") for v in vertices)
+
+
+def test_mergeStructures(tmp_path):
+    partition = Partition(Box(scale=(1.0, 0.5, 0.5)), 2, overlap=0.5)
+    paths = []
+    for cell, xs in enumerate([[-0.9, -0.1, 0.2], [-0.2, 0.3, 0.8]]):
+        path = str(tmp_path / "{}.sfm".format(cell))
+        with open(path, "w") as f:
+            json.dump({"version": ["1", "0", "0"], "views": [{"viewId": "1"}],
+                       "structure": [{"landmarkId": "7", "X": [str(x), "0", "0"]} for x in xs]}, f)
+        paths.append(path)
+    output = str(tmp_path / "merged.sfm")
+    mergeStructures(paths, partition, output)
+    with open(output) as f:
+        merged = json.load(f)
+    assert merged["views"] == [{"viewId": "1"}]
+    assert [float(l["X"][0]) for l in merged["structure"]] == [-0.9, -0.1, 0.3, 0.8]
+    assert [l["landmarkId"] for l in merged["structure"]] == ["0", "1", "2", "3"]
+
+
+def test_estimateBoundingBox(tmp_path):
+    sfmFile = str(tmp_path / "sfm.sfm")
+    structure = [{"X": [str(x), str(2 * x), "1"], "observations": [{}] * 3} for x in range(-10, 11)]
+    structure.append({"X": ["1000", "0", "0"], "observations": [{}]})
+    with open(sfmFile, "w") as f:
+        json.dump({"structure": structure}, f)
+    box = estimateBoundingBox(sfmFile, minObservations=2, margin=0.0)
+    assert box.translation == pytest.approx((0.0, 0.0, 1.0))
+    assert box.scale[0] == pytest.approx(10.0) and box.scale[1] == pytest.approx(20.0)
+
+
+def test_estimateBoundingBoxObservationAngle(tmp_path):
+    sfmFile = str(tmp_path / "sfm.sfm")
+    # two cameras 2 units apart, looking at landmarks at z=1 (wide angle) and z=100 (narrow angle)
+    structure = [{"X": [str(x), "0", str(z)], "observations": [{"observationId": "1"}, {"observationId": "2"}]}
+                 for x in range(-5, 6) for z in (1, 100)]
+    sfmData = {"structure": structure,  # before the views and poses
+               "views": [{"viewId": "1", "poseId": "1"}, {"viewId": "2", "poseId": "2"}, {"viewId": "3"}],
+               "poses": [{"poseId": p, "pose": {"transform": {"center": [str(x), "0", "0"]}}}
+                         for p, x in (("1", -1), ("2", 1))]}
+    with open(sfmFile, "w") as f:
+        json.dump(sfmData, f, indent=4)
+    box = estimateBoundingBox(sfmFile, minObservationAngle=10.0, quantile=0.0, margin=0.0)
+    assert box.translation == pytest.approx((0.0, 0.0, 1.0))
+    box = estimateBoundingBox(sfmFile, quantile=0.0, margin=0.0)
+    assert box.translation[2] == pytest.approx(50.5)
+
+
+def test_iterSfMData(tmp_path, monkeypatch):
+    sfmFile = str(tmp_path / "sfm.sfm")
+    sfmData = {"version": ["1", "0", "0"], "count": 12345, "featuresFolders": [],
+               "views": [{"viewId": str(i), "path": "/data/structure {}.jpg".format(i)} for i in range(20)],
+               "structure": [{"landmarkId": str(i), "X": ["0.5", "1", "2"]} for i in range(50)]}
+    with open(sfmFile, "w") as f:
+        json.dump(sfmData, f)
+    # tiny blocks: values are split between blocks
+    monkeypatch.setattr(meshPartition._JsonStream.__init__, "__defaults__", (7,))
+    items = list(iterSfMData(sfmFile))
+    assert [v for k, v in items if k == "structure"] == sfmData["structure"]
+    assert [v for k, v in items if k == "views"] == sfmData["views"]
+    assert ("count", 12345) in items and ("version", "1") in items
+    assert not [k for k, v in items if k == "featuresFolders"]
+
+
+def test_partitionedMeshing(tmp_path, fakeCommandLineNode):
+    commands = []
+
+    def meshing(chunk, cmd, args):
+        # fake meshing: a strip over the cell
+        commands.append(cmd)
+        cellBox = chunk.node.nodeDesc.partition(chunk.node).cellBox(chunk.index)
+        xs = [cellBox.toWorld((x, 0.0, 0.0))[0] for x in (-1.0, 0.0, 1.0)]
+        writeCellMesh(args["outputMesh"], xs)
+        with open(args["output"], "w") as f:
+            json.dump({"views": [], "structure": [{"X": [str(x), "0", "0"]} for x in xs]}, f)
+
+    node = fakeCommandLineNode("Meshing", meshing, partitionCells=3, useBoundingBox=True)
+    node.attribute("boundingBox.bboxScale.x").value = 3.0
+    assert len(node.chunks) == 3
+    assert node.output.value.endswith("densePointCloud.sfm")
+    for chunk in node.chunks:
+        node.nodeDesc.processChunk(chunk)
+    assert all(cmd.count("--boundingBox") == 1 and node.nodeDesc.chunksFolder(node) in cmd for cmd in commands)
+    assert os.path.isfile(node.outputMesh.value)
+    with open(node.output.value) as f:
+        assert len(json.load(f)["structure"]) > 0
+
+
+def test_partitionNeedsBox(tmp_path):
+    graph = Graph("")
+    graph.cacheDir = str(tmp_path / "cache")
+    # the box can not be estimated from an Alembic SfMData: the space is not partitioned
+    node = graph.addNewNode("Meshing", partitionCells=3, input=str(tmp_path / "sfm.abc"))
+    assert len(node.chunks) == 1
+    assert not node.partitionCells.desc.enabled(node)
+    assert node.output.value.endswith("densePointCloud.abc")
+    node.input.value = str(tmp_path / "sfm.sfm")
+    assert len(node.chunks) == 3
+    assert node.output.value.endswith("densePointCloud.sfm")
+    node.estimateSpaceFromSfM.value = False
+    assert len(node.chunks) == 1
+    node.input.value = str(tmp_path / "sfm.abc")
+    node.useBoundingBox.value = True
+    assert len(node.chunks) == 3
+
+
+def test_estimatedBoundingBoxStored(tmp_path, monkeypatch):
+    sfmFile = str(tmp_path / "sfm.sfm")
+    with open(sfmFile, "w") as f:
+        json.dump({"structure": [{"X": [str(x), "0", "0"], "observations": [{}] * 3} for x in range(-10, 11)]}, f)
+    graph = Graph("")
+    graph.cacheDir = str(tmp_path / "cache")
+    node = graph.addNewNode("Meshing", partitionCells=2, input=sfmFile, estimateSpaceMinObservationAngle=0.0)
+    calls = []
+
+    def estimate(*args):
+        calls.append(args)
+        return estimateBoundingBox(*args)
+
+    monkeypatch.setattr(sys.modules[type(node.nodeDesc).__module__], "estimateBoundingBox", estimate)
+    box = node.nodeDesc.partition(node).box
+    assert node.nodeDesc.partition(node).box.toList() == box.toList()
+    assert calls == [(sfmFile, 3, 0.0)]
+    assert os.path.isfile(os.path.join(node.nodeDesc.chunksFolder(node), "boundingBox.json"))
+    # the input has changed: estimated again
+    with open(sfmFile, "w") as f:
+        json.dump({"structure": [{"X": [str(x), "0", "0"], "observations": [{}] * 3} for x in range(0, 31)]}, f)
+    assert node.nodeDesc.partition(node).box.translation[0] == pytest.approx(15.0)
+    assert len(calls) == 2
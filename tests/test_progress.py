@@ -0,0 +1,76 @@
+from meshroom.core.progress import ProgressReader, ProgressWriter, TextProgressBarParser
+
+
+def test_progress_channel(tmp_path):
+    progressFile = str(tmp_path / "progress")
+    writer = ProgressWriter(progressFile)
+    reader = ProgressReader(progressFile)
+    assert not reader.read()
+    assert reader.progress == -1
+
+    writer.begin(10, "Step")
+    writer.update(5)
+    assert reader.read()
+    assert reader.progress == 0.5
+    assert reader.label == "Step"
+    # nothing appended since last read
+    assert not reader.read()
+
+    writer.update(10)
+    assert reader.read()
+    assert reader.progress == 1.0
+
+    # new computation truncates the channel
+    writer = ProgressWriter(progressFile)
+    writer.begin(4)
+    writer.update(1)
+    assert reader.read()
+    assert reader.progress == 0.25
+
+
+def test_text_progress_bar_parser(tmp_path):
+    progressFile = str(tmp_path / "progress")
+    parser = TextProgressBarParser(ProgressWriter(progressFile))
+    reader = ProgressReader(progressFile)
+
+    parser.feed(b"[info] start\n")
+    assert not reader.read()
+
+    parser.feed(b"\n0%   10   20   30   40   50   60   70   80   90   100%\n")
+    parser.feed(b"|----|----|----|----|----|----|----|----|----|----|\n")
+    parser.feed(b"*****")
+    assert reader.read()
+    assert reader.value == 5
+    assert reader.total == TextProgressBarParser.total
+
+    parser.feed(b"*" * 46 + b"\n[info] done\n***")
+    assert reader.read()
+    assert reader.progress == 1.0
+    # stars out of a progress bar are ignored
+    assert not reader.read()
+
+
+def test_log_progress_bar(tmp_path):
+    from meshroom.core.node import LogManager
+
+    class FakeChunk(object):
+        logFile = str(tmp_path / "log")
+        progressFile = str(tmp_path / "progress")
+
+        class node(object):
+            @staticmethod
+            def getName():
+                return "FakeNode"
+
+    logManager = LogManager(FakeChunk())
+    logManager.start('info')
+    # non ascii message: the progress bar line is found by its byte offset
+    logManager.makeProgressBar(10, u"Étape")
+    for value in range(1, 11):
+        logManager.updateProgressBar(value)
+    logManager.completeProgressBar()
+    logManager.end()
+    with open(FakeChunk.logFile, 'rb') as f:
+        lines = f.read().decode('utf-8').splitlines()
+    assert lines[0] == u"Étape"
+    assert lines[-1] == '*' * 51
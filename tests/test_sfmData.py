@@ -0,0 +1,75 @@
+#!/usr/bin/env python
+# coding:utf-8
+import json
+import os
+
+from meshroom.core.sfmData import parseSfMJsonFile, SfMDataCache, _JsonObjectReader
+
+
+def writeSfMData(filepath, structureFirst=False):
+    views = [{"viewId": str(i), "poseId": str(i), "intrinsicId": "0", "path": "/img/{}.jpg".format(i)} for i in range(10)]
+    poses = [{"poseId": str(i), "pose": {"transform": {"rotation": ["1"] * 9, "center": [str(i), "0", "0"]}}} for i in range(5)]
+    intrinsics = [{"intrinsicId": "0", "pxFocalLength": "1000"}]
+    structure = [{"landmarkId": str(i), "X": ["0.1", "0.2", "0.3"], "observations": []} for i in range(1000)]
+    items = [("version", ["1", "0", "0"]), ("views", views), ("intrinsics", intrinsics), ("poses", poses)]
+    items.insert(1 if structureFirst else len(items), ("structure", structure))
+    with open(filepath, 'w') as f:
+        f.write("{" + ",\n".join('"{}": {}'.format(k, json.dumps(v, indent=4)) for k, v in items) + "}")
+
+
+def test_parse_sfm_json(tmp_path):
+    for structureFirst in (False, True):
+        filepath = str(tmp_path / "sfm.json")
+        writeSfMData(filepath, structureFirst)
+        views, poses, intrinsics = parseSfMJsonFile(filepath)
+        assert sorted(views.keys(), key=int) == [str(i) for i in range(10)]
+        assert poses["3"]["transform"]["center"] == ["3", "0", "0"]
+        assert intrinsics["0"]["pxFocalLength"] == "1000"
+    assert parseSfMJsonFile(str(tmp_path / "missing.json")) == ({}, {}, {})
+
+
+def test_json_object_reader_small_chunks(tmp_path):
+    filepath = str(tmp_path / "data.json")
+    data = {"a": 12345, "b": "some text", "c": [1.5, {"d": None}], "e": {}}
+    with open(filepath, 'w') as f:
+        json.dump(data, f, indent=2)
+    reader = _JsonObjectReader(open(filepath))
+    # values split across chunks are decoded correctly
+    reader.chunkSize = 3
+    assert {k: decode() for k, decode in reader.items()} == data
+
+
+def test_sfm_data_cache(tmp_path):
+    filepath = str(tmp_path / "sfm.json")
+    writeSfMData(filepath)
+    cache = SfMDataCache()
+    assert cache.get(filepath) is None
+    result = cache.load(filepath)
+    assert cache.get(filepath) is result
+    # modified file is parsed again
+    mtime = os.path.getmtime(filepath)
+    os.utime(filepath, (mtime + 10, mtime + 10))
+    assert cache.get(filepath) is None
+    assert cache.load(filepath) is not result
+
+
+def test_sfm_views_node_size(tmp_path):
+    from meshroom.core.graph import Graph
+    sfmFile = str(tmp_path / "sfm.sfm")
+    writeSfMData(sfmFile)
+    graph = Graph("")
+    node = graph.addNewNode("PanoramaWarping", input=sfmFile)
+    assert node.size == 10
+    assert len(node.chunks) == 2
+    node.input.value = str(tmp_path / "sfm.abc")
+    assert node.size == 1
+    # missing or truncated files
+    node.input.value = str(tmp_path / "missing.sfm")
+    assert node.size == 1
+    truncatedFile = str(tmp_path / "truncated.sfm")
+    with open(sfmFile) as src, open(truncatedFile, "w") as dst:
+        dst.write(src.read()[:50])
+    node.input.value = truncatedFile
+    assert node.size == 1
+    imageProcessing = graph.addNewNode("ImageProcessing", input=truncatedFile)
+    assert imageProcessing.size == 1
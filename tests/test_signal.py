@@ -0,0 +1,37 @@
+#!/usr/bin/env python
+# coding:utf-8
+
+from meshroom.common.PySignal import ClassSignal, Signal
+
+
+class Emitter(object):
+    changed = ClassSignal()
+
+    def notify(self, value):
+        self.changed.emit(value)
+
+
+def test_emit_without_slots():
+    signal = Signal()
+    # no slots connected: emit is a no-op
+    signal.emit(1)
+    assert signal.sender() is None
+
+
+def test_sender_resolved_on_demand():
+    emitter = Emitter()
+    received = []
+
+    def onChanged(value):
+        received.append((value, emitter.changed.sender()))
+
+    emitter.changed.connect(onChanged)
+    emitter.notify(3)
+    assert received == [(3, emitter.notify)]
+
+
+def test_class_signal_per_instance():
+    a, b = Emitter(), Emitter()
+    assert a.changed is a.changed
+    assert a.changed is not b.changed
+    assert Emitter.changed is Emitter.__dict__['changed']
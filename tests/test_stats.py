@@ -0,0 +1,27 @@
+#!/usr/bin/env python
+# coding:utf-8
+
+from meshroom.core.stats import DownsampledCurve
+
+
+def test_downsampled_curve_append():
+    curve = DownsampledCurve(maxPoints=4)
+    assert curve.update([1, 2]) == (False, [(0, 1.0), (1, 2.0)])
+    # only new samples are processed
+    assert curve.update([1, 2, "3"]) == (False, [(2, 3.0)])
+    assert curve.update([1, 2, 3]) == (False, [])
+
+
+def test_downsampled_curve_stride():
+    curve = DownsampledCurve(maxPoints=4)
+    curve.update([1, 2, 3, 4])
+    # exceeding maxPoints doubles the averaging window
+    assert curve.update([1, 2, 3, 4, 5, 6]) == (True, [])
+    assert curve.stride == 2
+    assert curve.points == [(0, 1.5), (2, 3.5), (4, 5.5)]
+    # incomplete window is not displayed yet
+    assert curve.update([1, 2, 3, 4, 5, 6, 7]) == (False, [])
+    assert curve.update([1, 2, 3, 4, 5, 6, 7, 8]) == (False, [(6, 7.5)])
+    # less samples: new computation
+    assert curve.update([2]) == (True, [])
+    assert curve.points == [(0, 2.0)]
@@ -0,0 +1,112 @@
+#!/usr/bin/env python
+# coding:utf-8
+
+from meshroom.core.textFile import TextFileIndex
+
+
+def test_incremental_update(tmp_path):
+    filepath = str(tmp_path / "log")
+    index = TextFileIndex(filepath)
+    # file does not exist yet
+    assert index.update() is None
+
+    with open(filepath, 'w') as f:
+        f.write("line 0\nline 1\nline")
+    assert index.update() == (True, 0)
+    assert index.lineCount == 3
+    assert [index.line(i) for i in range(3)] == ["line 0", "line 1", "line"]
+    assert index.update() is None
+
+    # complete the last line and add new ones: only appended bytes are read
+    with open(filepath, 'a') as f:
+        f.write(" 2\nline 3\n")
+    assert index.update() == (False, 2)
+    assert index.lineCount == 4
+    assert index.line(2) == "line 2"
+    assert index.line(3) == "line 3"
+
+    with open(filepath, 'a') as f:
+        f.write("line 4\n")
+    assert index.update() == (False, 4)
+    assert index.text(3, 4) == "line 3\nline 4\n"
+
+    # truncation resets the index
+    with open(filepath, 'w') as f:
+        f.write("new\n")
+    assert index.update() == (True, 0)
+    assert index.lineCount == 1
+    assert index.line(0) == "new"
+
+
+def test_rewritten_lines(tmp_path):
+    filepath = str(tmp_path / "log")
+    with open(filepath, 'w') as f:
+        f.write("start\n" + " " * 10 + "\nend\n")
+    index = TextFileIndex(filepath)
+    index.update()
+    assert index.line(1) == " " * 10
+
+    # progress bar filled in its reserved line: same file size
+    with open(filepath, 'r+') as f:
+        f.seek(6)
+        f.write("***")
+    assert index.update() == (False, 1)
+    assert index.line(1) == "***" + " " * 7
+    assert index.update() is None
+
+    # rewritten and appended
+    with open(filepath, 'r+') as f:
+        f.seek(9)
+        f.write("**")
+        f.seek(0, 2)
+        f.write("next\n")
+    assert index.update() == (False, 1)
+    assert index.lineCount == 4
+    assert index.line(1) == "*****" + " " * 5
+
+    # line endings rewritten: the index is rebuilt
+    with open(filepath, 'r+') as f:
+        f.seek(8)
+        f.write("\n")
+    assert index.update() == (True, 0)
+    assert index.lineCount == 5
+
+
+def test_tail_and_older_lines(tmp_path):
+    filepath = str(tmp_path / "log")
+    lines = ["line {:03d}".format(i) for i in range(100)]
+    with open(filepath, 'w') as f:
+        f.write("\n".join(lines) + "\n")
+
+    # only index the end of the file
+    index = TextFileIndex(filepath, tailSize=45)
+    index.update()
+    assert index.hasOlderLines
+    assert index.lineCount == 5
+    assert index.line(0) == "line 095"
+
+    # older lines are read without changing the index until they are inserted
+    starts = index.readOlderLines(maxBytes=20)
+    assert len(starts) == 2
+    assert index.lineCount == 5
+    assert index.line(0) == "line 095"
+    inserted = index.insertOlderLines(starts)
+    assert inserted == 2
+    assert index.line(0) == "line 093"
+    while index.hasOlderLines:
+        index.loadOlder(maxBytes=100)
+    assert [index.line(i) for i in range(index.lineCount)] == lines
+
+
+def test_find(tmp_path):
+    filepath = str(tmp_path / "log")
+    with open(filepath, 'w') as f:
+        f.write("\n".join(["info", "[warning] Something", "info", "[Warning] Other", "info"]))
+    index = TextFileIndex(filepath)
+    index.blockSize = 8  # search across several blocks
+    index.update()
+    assert index.find("[warning]") == 1
+    assert index.find("[warning]", fromLine=2) == 3
+    assert index.find("[warning]", fromLine=2, caseSensitive=True) == -1
+    assert index.find("[warning]", fromLine=2, backward=True) == 1
+    assert index.find("missing") == -1
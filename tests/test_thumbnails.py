@@ -0,0 +1,111 @@
+#!/usr/bin/env python
+# coding:utf-8
+import os
+import threading
+import time
+
+from meshroom.core.thumbnails import ThumbnailCache
+
+
+def writeThumbnail(imagePath, thumbnailPath):
+    with open(thumbnailPath, 'w') as f:
+        f.write('thumbnail of ' + os.path.basename(imagePath))
+    return True
+
+
+def test_thumbnailCreation(tmp_path):
+    image = tmp_path / "image.jpg"
+    image.write_text(u"image")
+    created = []
+
+    def createThumbnail(imagePath, thumbnailPath):
+        created.append(imagePath)
+        return writeThumbnail(imagePath, thumbnailPath)
+
+    cache = ThumbnailCache(str(tmp_path / "cache"), createThumbnail, maxWorkers=2)
+    assert cache.cached(str(image)) is None
+    thumbnail = cache.get(str(image))
+    assert thumbnail and open(thumbnail).read() == "thumbnail of image.jpg"
+    # cache hit
+    assert cache.get(str(image)) == thumbnail
+    # another cache using the same folder
+    assert ThumbnailCache(str(tmp_path / "cache"), createThumbnail).cached(str(image)) == thumbnail
+    assert len(created) == 1
+
+    # modified image: new thumbnail
+    time.sleep(0.01)
+    image.write_text(u"modified image")
+    assert cache.cached(str(image)) is None
+    assert cache.get(str(image)) not in (None, thumbnail)
+    assert len(created) == 2
+    # missing image / creation failure
+    assert cache.get(str(tmp_path / "missing.jpg")) is None
+    assert ThumbnailCache(str(tmp_path / "cache2"), lambda i, t: False).get(str(image)) is None
+    cache.close()
+
+
+def test_prefetch(tmp_path):
+    images = []
+    for i in range(20):
+        image = tmp_path / "image{}.jpg".format(i)
+        image.write_text(u"image")
+        images.append(str(image))
+    cache = ThumbnailCache(str(tmp_path / "cache"), writeThumbnail, maxWorkers=4)
+    cache.prefetch(images)
+    # requests wait for pending prefetches
+    assert all(cache.get(image) for image in images)
+    cache.close()
+
+
+def test_cleanup(tmp_path):
+    images = []
+    for i in range(5):
+        image = tmp_path / "image{}.jpg".format(i)
+        image.write_text(u"image")
+        images.append(str(image))
+    cache = ThumbnailCache(str(tmp_path / "cache"), writeThumbnail, maxWorkers=1)
+    thumbnails = [cache.get(image) for image in images]
+    for i, thumbnail in enumerate(thumbnails):
+        os.utime(thumbnail, (i, i))
+    thumbnailSize = os.path.getsize(thumbnails[0])
+    cache.maxCacheSize = 3 * thumbnailSize
+    assert cache.cleanup() == 2
+    # oldest thumbnails have been removed
+    assert [cache.cached(image) is not None for image in images] == [False, False, True, True, True]
+    cache.close()
+
+
+def test_closeReleasesWaiters(tmp_path):
+    image = tmp_path / "image.jpg"
+    image.write_text(u"image")
+    started = threading.Event()
+
+    def blockedThumbnail(imagePath, thumbnailPath):
+        started.set()
+        time.sleep(0.5)
+        return False
+
+    cache = ThumbnailCache(str(tmp_path / "cache"), blockedThumbnail, maxWorkers=1)
+    assert cache.get(str(image), timeout=0.01) is None
+    results = []
+    waiting = threading.Thread(target=lambda: results.append(cache.get(str(image))))
+    waiting.start()
+    started.wait(1)
+    cache.close()
+    waiting.join(0.2)
+    assert not waiting.is_alive() and results == [None]
+    assert not cache._pending
+
+
+def test_requestCallback(tmp_path):
+    image = tmp_path / "image.jpg"
+    image.write_text(u"image")
+    cache = ThumbnailCache(str(tmp_path / "cache"), writeThumbnail, maxWorkers=1)
+    done = threading.Event()
+    assert cache.request(str(image), done.set) is not None
+    # called once the thumbnail exists
+    assert done.wait(1) and cache.cached(str(image))
+    # not called for cached thumbnails
+    assert cache.request(str(image), lambda: None) is None
+    assert not cache._callbacks
+    cache.close()
@@ -0,0 +1,67 @@
+#!/usr/bin/env python
+# coding:utf-8
+import json
+from collections import namedtuple
+
+from meshroom.core import viewpointMetadata
+from meshroom.core.viewpointMetadata import parseMetadata, estimateNbBrackets
+
+Value = namedtuple("Value", ["value"])
+Viewpoint = namedtuple("Viewpoint", ["path", "metadata"])
+
+
+def viewpoint(path, metadata):
+    return Viewpoint(Value(path), Value(json.dumps(metadata) if metadata is not None else ""))
+
+
+def bracketedViewpoints(nbViews, exposures):
+    return [viewpoint("img_{:04d}.jpg".format(i), {"Exif:FNumber": "8", "Exif:ShutterSpeedValue": exposures[i % len(exposures)],
+                                                   "Exif:ISOSpeedRatings": "100"})
+            for i in range(nbViews * len(exposures))]
+
+
+def test_parseMetadata():
+    metadataStr = json.dumps({"Exif:FNumber": "5.6", "Exif:ShutterSpeedValue": "0.01", "ISO": "200", "Make": "Foo"})
+    metadata = parseMetadata(metadataStr)
+    assert metadata.fNumber == 5.6 and metadata.shutterSpeed == 0.01 and metadata.iso == 200.0
+    assert metadata.make == "Foo" and metadata.focalLength is None
+    assert metadata.hasExposure
+    # parsed once
+    assert parseMetadata(metadataStr) is metadata
+    assert parseMetadata("") is None
+    assert parseMetadata("{invalid") is None
+
+
+def test_estimateNbBrackets():
+    viewpointMetadata.clearCache()
+    assert estimateNbBrackets(bracketedViewpoints(10, ["0.01", "0.1", "1"])) == 3
+    # single exposure, multiple views
+    assert estimateNbBrackets(bracketedViewpoints(10, ["0.01"])) == 1
+    # single view, multiple exposures
+    assert estimateNbBrackets(bracketedViewpoints(1, ["0.01", "0.1"])) == 2
+    # missing metadata or exposure
+    assert estimateNbBrackets(bracketedViewpoints(2, ["0.01", "0.1"]) + [viewpoint("a.jpg", None)]) == 0
+    assert estimateNbBrackets(bracketedViewpoints(2, ["0.01", "0.1"]) + [viewpoint("a.jpg", {"Make": "Foo"})]) == 1
+    # inconsistent brackets
+    assert estimateNbBrackets(bracketedViewpoints(2, ["0.01", "0.1"])[:-1]) == 0
+    assert estimateNbBrackets([]) == 0
+
+
+def test_nbBracketsCache(monkeypatch):
+    viewpointMetadata.clearCache()
+    computed = []
+    compute = viewpointMetadata._computeNbBrackets
+
+    def countingCompute(viewpoints):
+        computed.append(len(viewpoints))
+        return compute(viewpoints)
+
+    monkeypatch.setattr(viewpointMetadata, "_computeNbBrackets", countingCompute)
+    viewpoints = bracketedViewpoints(5, ["0.01", "0.1", "1"])
+    # several nodes depending on the same CameraInit
+    for _ in range(3):
+        assert estimateNbBrackets(viewpoints) == 3
+    assert computed == [15]
+    # modified viewpoints
+    assert estimateNbBrackets(viewpoints[:-3]) == 3
+    assert computed == [15, 12]